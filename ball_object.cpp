@@ -3,7 +3,7 @@
 BallObject::BallObject()
     : GameObject(), m_radius(12.5f), m_stuck(true), m_sticky(false), m_passThrough(false) {}
 
-BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite)
+BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Sprite sprite)
     : GameObject(pos, glm::vec2(radius * 2.0f, radius * 2.0f), sprite, glm::vec3(1.0), velocity), m_radius(radius), m_stuck(true),
     m_sticky(false), m_passThrough(false)
 {}
@@ -1,11 +1,9 @@
 #ifndef BALLOBJECT_H
 #define BALLOBJECT_H
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "game_object.h"
-#include "texture.h"
 
 class BallObject : public GameObject {
 public:
@@ -14,7 +12,7 @@ public:
     bool m_sticky, m_passThrough;
 
     BallObject();
-    BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite);
+    BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Sprite sprite);
     
     glm::vec2 move(float dt, unsigned int window_width);
     void reset(glm::vec2 position, glm::vec2 velocity);
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "particle_pool.h"
+#include "particle_emitter.h"
+#include "collision.h"
+#include "game.h"
+#include "file_system.h"
+
+// links only breakout_core, everything measured here is plain CPU code without a GL context
+
+const unsigned int UPDATES_PER_RUN = 30;
+const float UPDATE_DT = 1.0f / 120.0f;
+const unsigned int COLLISION_PAIRS = 4096;
+const unsigned int LEVEL_OPS_PER_RUN = 20;
+const unsigned int STEPS_PER_RUN = 600;
+const unsigned int STEP_SEED = 1337;
+const unsigned int BENCH_WIDTH = 800;
+const unsigned int BENCH_HEIGHT = 600;
+
+enum OutputFormat {
+    OUTPUT_TABLE,
+    OUTPUT_CSV,
+    OUTPUT_JSON
+};
+
+struct BenchOptions {
+    std::string m_filter;
+    unsigned int m_warmup;
+    unsigned int m_runs;
+    OutputFormat m_format;
+};
+
+// m_prepare runs once before the first run and builds the fixtures, so benchmarks left out by --filter allocate
+// nothing. m_setup runs untimed before every run, m_run performs m_ops operations
+struct Benchmark {
+    std::string m_name;
+    unsigned int m_ops;
+    std::function<void()> m_prepare;
+    std::function<void()> m_setup;
+    std::function<void()> m_run;
+};
+
+struct BenchResult {
+    std::string m_name;
+    unsigned int m_ops;
+    unsigned int m_runs;
+    double m_best, m_median; // ns per operation
+};
+
+// keeps results alive so the compiler cannot drop the benchmarked calls
+volatile unsigned int sink;
+
+BenchResult runBenchmark(const Benchmark& bench, const BenchOptions& options) {
+    if (bench.m_prepare) {
+        bench.m_prepare();
+    }
+    std::vector<double> samples;
+    for (unsigned int run = 0; run < options.m_warmup + options.m_runs; ++run) {
+        if (bench.m_setup) {
+            bench.m_setup();
+        }
+        auto start = std::chrono::steady_clock::now();
+        bench.m_run();
+        auto end = std::chrono::steady_clock::now();
+        if (run >= options.m_warmup) {
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / bench.m_ops);
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    BenchResult result = { bench.m_name, bench.m_ops, options.m_runs, samples.front(), samples[samples.size() / 2] };
+    return result;
+}
+
+float randomFloat(float min, float max) {
+    return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+void fillPool(ParticlePool& pool) {
+    srand(1337);
+    pool.update(2.0f); // expire whatever the previous run left alive
+    for (unsigned int i = 0; i < pool.size(); ++i) {
+        glm::vec2 position(rand() % 800, rand() % 600);
+        glm::vec2 velocity(((rand() % 200) - 100) * 0.1f, ((rand() % 200) - 100) * 0.1f);
+        float life = 0.25f + (rand() % 75) / 100.0f;
+        pool.spawn(position, velocity, glm::vec4(1.0f), life);
+    }
+}
+
+const unsigned int PARTICLE_AMOUNTS[] = { 500, 50000, 1000000 };
+
+void addParticlePoolBenchmarks(std::vector<Benchmark>& benchmarks) {
+    for (unsigned int amount : PARTICLE_AMOUNTS) {
+        for (int simd = 0; simd < 2; ++simd) {
+            std::shared_ptr<ParticlePool> pool = std::make_shared<ParticlePool>(0);
+            std::string kernel = simd ? ParticlePool::kernelName() : "scalar";
+            benchmarks.push_back({ "ParticlePool::update/" + kernel + "/" + std::to_string(amount), UPDATES_PER_RUN,
+                [pool, amount]() { *pool = ParticlePool(amount); },
+                [pool]() { fillPool(*pool); },
+                [pool, simd]() {
+                    for (unsigned int i = 0; i < UPDATES_PER_RUN; ++i) {
+                        if (simd) {
+                            pool->update(UPDATE_DT);
+                        } else {
+                            pool->updateScalar(UPDATE_DT);
+                        }
+                    }
+                } });
+        }
+    }
+}
+
+// ParticleGenerator::update as the CPU backend runs it: the trail particles spawned behind the ball with the
+// emitter's own Random, then the pool update. the pool starts full and gets enough spawns per update to stay full
+void addParticleEmitterBenchmarks(std::vector<Benchmark>& benchmarks) {
+    GameObject ball(glm::vec2(BENCH_WIDTH / 2.0f, BENCH_HEIGHT / 2.0f), glm::vec2(BALL_RADIUS * 2.0f), SPRITE_FACE,
+        glm::vec3(1.0f), INITIAL_BALL_VELOCITY);
+    glm::vec2 offset(BALL_RADIUS / 2.0f);
+    for (unsigned int amount : PARTICLE_AMOUNTS) {
+        std::shared_ptr<ParticleEmitter> emitter = std::make_shared<ParticleEmitter>(0);
+        unsigned int spawns = std::max(2u, static_cast<unsigned int>(amount * UPDATE_DT / PARTICLE_LIFE));
+        benchmarks.push_back({ "ParticleEmitter::update/" + std::to_string(amount), UPDATES_PER_RUN,
+            [emitter, amount]() { *emitter = ParticleEmitter(amount); },
+            [emitter]() { fillPool(emitter->m_particles); },
+            [emitter, ball, offset, spawns]() {
+                for (unsigned int i = 0; i < UPDATES_PER_RUN; ++i) {
+                    emitter->update(UPDATE_DT, ball, spawns, offset);
+                }
+                sink = emitter->m_particles.liveCount();
+            } });
+    }
+}
+
+void addCollisionBenchmarks(std::vector<Benchmark>& benchmarks) {
+    std::shared_ptr<std::vector<GameObject>> boxes = std::make_shared<std::vector<GameObject>>();
+    std::shared_ptr<std::vector<BallObject>> balls = std::make_shared<std::vector<BallObject>>();
+    std::shared_ptr<std::vector<glm::vec2>> directions = std::make_shared<std::vector<glm::vec2>>();
+    // shared by the three benchmarks, about half of the random pairs overlap
+    std::function<void()> prepare = [boxes, balls, directions]() {
+        if (!boxes->empty()) {
+            return;
+        }
+        srand(42);
+        for (unsigned int i = 0; i < COLLISION_PAIRS; ++i) {
+            boxes->push_back(GameObject(glm::vec2(randomFloat(0.0f, 100.0f), randomFloat(0.0f, 100.0f)),
+                glm::vec2(randomFloat(10.0f, 60.0f), randomFloat(10.0f, 30.0f)), SPRITE_BLOCK));
+            balls->push_back(BallObject(glm::vec2(randomFloat(0.0f, 100.0f), randomFloat(0.0f, 100.0f)),
+                BALL_RADIUS, INITIAL_BALL_VELOCITY, SPRITE_FACE));
+            directions->push_back(glm::vec2(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f)));
+        }
+    };
+
+    benchmarks.push_back({ "checkCollision/aabb", COLLISION_PAIRS, prepare, nullptr, [boxes]() {
+        unsigned int hits = 0;
+        for (unsigned int i = 0; i < COLLISION_PAIRS; ++i) {
+            hits += checkCollision((*boxes)[i], (*boxes)[(i + 1) % COLLISION_PAIRS]);
+        }
+        sink = hits;
+    } });
+    benchmarks.push_back({ "checkCollision/ball", COLLISION_PAIRS, prepare, nullptr, [balls, boxes]() {
+        unsigned int hits = 0;
+        for (unsigned int i = 0; i < COLLISION_PAIRS; ++i) {
+            hits += std::get<0>(checkCollision((*balls)[i], (*boxes)[i]));
+        }
+        sink = hits;
+    } });
+    benchmarks.push_back({ "vectorDirection", COLLISION_PAIRS, prepare, nullptr, [directions]() {
+        unsigned int total = 0;
+        for (const glm::vec2& direction : *directions) {
+            total += vectorDirection(direction);
+        }
+        sink = total;
+    } });
+}
+
+// a full grid of breakable bricks with a solid border on the top row
+std::vector<std::vector<unsigned int>> generateTiles(unsigned int width, unsigned int height) {
+    std::vector<std::vector<unsigned int>> tiles(height, std::vector<unsigned int>(width));
+    for (unsigned int y = 0; y < height; ++y) {
+        for (unsigned int x = 0; x < width; ++x) {
+            tiles[y][x] = y == 0 ? 1 : 2 + (x + y) % 4;
+        }
+    }
+    return tiles;
+}
+
+// the ball sits below the bricks, so every call scans the whole level without changing it
+void prepareCollisionGame(Game& game, const GameLevel& level) {
+    game.init();
+    game.m_levels[0] = level;
+    game.m_level = 0;
+    game.m_state = GAME_ACTIVE;
+    game.m_ball.m_stuck = false;
+    game.m_ball.m_position = glm::vec2(BENCH_WIDTH / 2.0f, BENCH_HEIGHT * 0.7f);
+}
+
+void addLevelBenchmarks(std::vector<Benchmark>& benchmarks) {
+    const char* files[] = { "levels/one.lvl", "levels/two.lvl", "levels/three.lvl", "levels/four.lvl" };
+    for (const char* file : files) {
+        std::string name = std::string(file).substr(7);
+        std::shared_ptr<GameLevel> level = std::make_shared<GameLevel>();
+        benchmarks.push_back({ "GameLevel::load/" + name, LEVEL_OPS_PER_RUN, nullptr, nullptr, [level, file]() {
+            for (unsigned int i = 0; i < LEVEL_OPS_PER_RUN; ++i) {
+                level->load(file, BENCH_WIDTH, BENCH_HEIGHT / 2);
+            }
+            sink = level->m_bricks.size();
+        } });
+
+        std::shared_ptr<Game> game = std::make_shared<Game>(BENCH_WIDTH, BENCH_HEIGHT);
+        benchmarks.push_back({ "Game::doCollisions/" + name, LEVEL_OPS_PER_RUN,
+            [game, file]() {
+                GameLevel loaded;
+                loaded.load(file, BENCH_WIDTH, BENCH_HEIGHT / 2);
+                prepareCollisionGame(*game, loaded);
+            },
+            nullptr,
+            [game]() {
+            for (unsigned int i = 0; i < LEVEL_OPS_PER_RUN; ++i) {
+                game->doCollisions();
+            }
+        } });
+    }
+
+    const unsigned int sizes[][2] = { { 64, 32 }, { 256, 128 } };
+    for (const unsigned int* size : sizes) {
+        std::shared_ptr<Game> game = std::make_shared<Game>(BENCH_WIDTH, BENCH_HEIGHT);
+        unsigned int width = size[0], height = size[1];
+        std::string name = "generated-" + std::to_string(width) + "x" + std::to_string(height);
+        benchmarks.push_back({ "Game::doCollisions/" + name, LEVEL_OPS_PER_RUN,
+            [game, width, height]() {
+                GameLevel generated;
+                generated.init(generateTiles(width, height), BENCH_WIDTH, BENCH_HEIGHT / 2);
+                prepareCollisionGame(*game, generated);
+            },
+            nullptr,
+            [game]() {
+            for (unsigned int i = 0; i < LEVEL_OPS_PER_RUN; ++i) {
+                game->doCollisions();
+            }
+        } });
+    }
+}
+
+void addSimulationBenchmarks(std::vector<Benchmark>& benchmarks) {
+    // whole simulation steps from a freshly launched ball, the same seed and input every run
+    for (unsigned int level = 0; level < 4; ++level) {
+        std::shared_ptr<Game> game = std::make_shared<Game>(BENCH_WIDTH, BENCH_HEIGHT);
+        benchmarks.push_back({ "Game::step/level" + std::to_string(level + 1), STEPS_PER_RUN, nullptr,
+            [game, level]() {
+                game->init();
+                game->m_random.seed(STEP_SEED);
+                game->m_powerups.clear();
+                game->m_lives = 3;
+                game->m_level = level;
+                game->m_state = GAME_ACTIVE;
+            },
+            [game]() {
+                GameInput input = {};
+                input.m_launch = true;
+                for (unsigned int i = 0; i < STEPS_PER_RUN; ++i) {
+                    game->step(input, UPDATE_DT);
+                }
+                sink = game->m_powerups.size();
+            } });
+    }
+
+    const char* types[] = { "speed", "sticky", "pass-through", "pad-size-increase", "confuse", "chaos" };
+    const unsigned int counts[] = { 100, 1000 };
+    for (unsigned int count : counts) {
+        std::shared_ptr<Game> game = std::make_shared<Game>(BENCH_WIDTH, BENCH_HEIGHT);
+        // activated power-ups with durations that never run out stay in the list, so every run sees the same load
+        std::function<void()> prepare = [game, count, types]() {
+            game->init();
+            for (unsigned int i = 0; i < count; ++i) {
+                PowerUp powerUp(types[i % 6], glm::vec3(1.0f), 1e9f, glm::vec2(i % BENCH_WIDTH, 0.0f), SPRITE_POWERUP_SPEED);
+                powerUp.m_activated = i % 2 == 0;
+                game->m_powerups.push_back(powerUp);
+            }
+        };
+        benchmarks.push_back({ "Game::updatePowerUps/" + std::to_string(count), UPDATES_PER_RUN, prepare, nullptr, [game]() {
+            for (unsigned int i = 0; i < UPDATES_PER_RUN; ++i) {
+                game->updatePowerUps(UPDATE_DT);
+            }
+        } });
+    }
+}
+
+void printResults(const std::vector<BenchResult>& results, OutputFormat format) {
+    if (format == OUTPUT_CSV) {
+        printf("name,ops_per_run,runs,best_ns_per_op,median_ns_per_op\n");
+        for (const BenchResult& result : results) {
+            printf("%s,%u,%u,%.3f,%.3f\n", result.m_name.c_str(), result.m_ops, result.m_runs, result.m_best, result.m_median);
+        }
+    } else if (format == OUTPUT_JSON) {
+        printf("{\n  \"simd_kernel\": \"%s\",\n  \"benchmarks\": [", ParticlePool::kernelName());
+        for (unsigned int i = 0; i < results.size(); ++i) {
+            const BenchResult& result = results[i];
+            printf("%s\n    { \"name\": \"%s\", \"ops_per_run\": %u, \"runs\": %u, \"best_ns_per_op\": %.3f, \"median_ns_per_op\": %.3f }",
+                i > 0 ? "," : "", result.m_name.c_str(), result.m_ops, result.m_runs, result.m_best, result.m_median);
+        }
+        printf("\n  ]\n}\n");
+    } else {
+        printf("simd kernel: %s\n", ParticlePool::kernelName());
+        printf("%-40s %12s %14s %14s\n", "benchmark", "ops/run", "best ns/op", "median ns/op");
+        for (const BenchResult& result : results) {
+            printf("%-40s %12u %14.3f %14.3f\n", result.m_name.c_str(), result.m_ops, result.m_best, result.m_median);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // --filter <text> only runs benchmarks whose name contains text, --warmup <n> and --runs <n> set the untimed and
+    // timed runs per benchmark, --csv and --json switch the output to a machine-readable format
+    BenchOptions options = { "", 2, 20, OUTPUT_TABLE };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            options.m_filter = argv[++i];
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.m_warmup = std::atoi(argv[++i]);
+        } else if (arg == "--runs" && i + 1 < argc) {
+            options.m_runs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--csv") {
+            options.m_format = OUTPUT_CSV;
+        } else if (arg == "--json") {
+            options.m_format = OUTPUT_JSON;
+        }
+    }
+
+    // the levels are found relative to the repository root, the same place the game looks from build/bin
+    if (access("levels", F_OK) != 0) {
+        FileSystem::chDir();
+        FileSystem::chDir();
+    }
+
+    std::vector<Benchmark> benchmarks;
+    addCollisionBenchmarks(benchmarks);
+    addLevelBenchmarks(benchmarks);
+    addSimulationBenchmarks(benchmarks);
+    addParticlePoolBenchmarks(benchmarks);
+    addParticleEmitterBenchmarks(benchmarks);
+
+    std::vector<BenchResult> results;
+    for (const Benchmark& bench : benchmarks) {
+        if (bench.m_name.find(options.m_filter) != std::string::npos) {
+            results.push_back(runBenchmark(bench, options));
+        }
+    }
+    printResults(results, options.m_format);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "collision.h"
+
+bool checkCollision(const GameObject& one, const GameObject& two) {
+    bool collisionX = one.m_position.x + one.m_size.x >= two.m_position.x &&
+        two.m_position.x + two.m_size.x >= one.m_position.x;
+
+    bool collisionY = one.m_position.y + one.m_size.y >= two.m_position.y &&
+        two.m_position.y + two.m_size.y >= one.m_position.y;
+
+    return collisionX && collisionY;
+}
+
+Collision checkCollision(const BallObject& one, const GameObject& two) {
+    glm::vec2 center(one.m_position + one.m_radius);
+
+    glm::vec2 aabb_half_extents(two.m_size.x / 2.0f, two.m_size.y / 2.0f);
+    glm::vec2 aabb_center(two.m_position.x + aabb_half_extents.x, two.m_position.y + aabb_half_extents.y);
+
+    glm::vec2 difference = center - aabb_center;
+    glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
+
+    glm::vec2 closest = aabb_center + clamped;
+    difference = closest - center;
+
+    if (glm::length(difference) < one.m_radius) {
+        return std::make_tuple(true, vectorDirection(difference), difference);
+    } else {
+        return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
+    }
+}
+
+Direction vectorDirection(glm::vec2 target) {
+    glm::vec2 compass[] = {
+        glm::vec2(0.0f, 1.0f),  // up
+        glm::vec2(1.0f, 0.0f),  // right
+        glm::vec2(0.0f, -1.0f), // down
+        glm::vec2(-1.0f, 0.0f)  // left
+    };
+    float max = 0.0f;
+    unsigned int best_match = -1;
+    for (unsigned int i = 0; i < 4; ++i) {
+        float dot_product = glm::dot(glm::normalize(target), compass[i]);
+        if (dot_product > max) {
+            max = dot_product;
+            best_match = i;
+        }
+    }
+    return (Direction)best_match;
+}
\ No newline at end of file
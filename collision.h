@@ -0,0 +1,27 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <tuple>
+
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+#include "ball_object.h"
+
+enum Direction {
+    UP,
+    RIGHT,
+    DOWN, 
+    LEFT
+};
+
+typedef std::tuple<bool, Direction, glm::vec2> Collision;
+
+// AABB - AABB
+bool checkCollision(const GameObject& one, const GameObject& two);
+// circle - AABB, the vector is from the ball's center to the closest point on the box
+Collision checkCollision(const BallObject& one, const GameObject& two);
+// which of the four compass directions target points closest to
+Direction vectorDirection(glm::vec2 target);
+
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef FILESYSTEM_H
 #define FILESYSTEM_H
 
+#include <sys/stat.h>
 #include <unistd.h>
 #include <string>
 
@@ -19,6 +20,10 @@ public:
         return "";
     }
 
+    static void makeDir(const std::string& path) {
+        mkdir(path.c_str(), 0755);
+    }
+
     static void chDir() {
         int i = chdir("..");
         if (i < 0) {
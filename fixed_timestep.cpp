@@ -0,0 +1,21 @@
+#include "fixed_timestep.h"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(float rate, float maxCatchUp)
+    : m_stepTime(1.0f / rate), m_maxSteps(std::max(1u, static_cast<unsigned int>(rate * maxCatchUp))), m_accumulator(0.0),
+    m_dropped(0)
+{}
+
+unsigned int FixedTimestep::advance(float frameTime) {
+    this->m_accumulator += frameTime;
+    unsigned int steps = static_cast<unsigned int>(this->m_accumulator / this->m_stepTime);
+    if (steps > this->m_maxSteps) {
+        // the fraction of a step is kept, only the whole steps beyond the cap are dropped
+        this->m_dropped += steps - this->m_maxSteps;
+        this->m_accumulator -= static_cast<double>(this->m_stepTime) * (steps - this->m_maxSteps);
+        steps = this->m_maxSteps;
+    }
+    this->m_accumulator -= static_cast<double>(this->m_stepTime) * steps;
+    return steps;
+}
\ No newline at end of file
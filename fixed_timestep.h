@@ -0,0 +1,30 @@
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+// turns variable frame times into a whole number of fixed simulation steps. the time left over after the last step
+// carries into the next frame and alpha() says how far it reaches into the next step. the renderer blends the previous
+// and the current step by it, so the picture trails the simulation by less than one step but moves smoothly.
+// after a hitch the backlog beyond the catch-up limit is dropped, so the game slows down for a moment instead of
+// spending every following frame catching up
+class FixedTimestep {
+public:
+    // maxCatchUp is the most game time one frame runs steps for, at least one step
+    FixedTimestep(float rate, float maxCatchUp);
+
+    // adds one frame's time and returns how many steps to run before rendering it
+    unsigned int advance(float frameTime);
+
+    float stepTime() const { return this->m_stepTime; }
+    // 0 is the state before the last step, 1 the state after it
+    float alpha() const { return static_cast<float>(this->m_accumulator / this->m_stepTime); }
+    unsigned long long droppedSteps() const { return this->m_dropped; }
+private:
+    float m_stepTime;
+    unsigned int m_maxSteps;
+    // double so adding and removing thousands of small steps does not leave rounding residue that shifts the
+    // frames a step falls into
+    double m_accumulator;
+    unsigned long long m_dropped;
+};
+
+#endif
\ No newline at end of file
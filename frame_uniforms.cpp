@@ -0,0 +1,29 @@
+#include "frame_uniforms.h"
+
+// instantiate static variables
+unsigned int FrameUniforms::m_UBO = 0;
+FrameBlock FrameUniforms::m_block = { glm::mat4(1.0f), 0.0f, { 0.0f, 0.0f, 0.0f } };
+
+void FrameUniforms::init() {
+    glGenBuffers(1, &m_UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), &m_block, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniforms::clear() {
+    glDeleteBuffers(1, &m_UBO);
+    m_UBO = 0;
+}
+
+void FrameUniforms::setProjection(const glm::mat4& projection) {
+    m_block.m_projection = projection;
+}
+
+void FrameUniforms::beginFrame(float time) {
+    m_block.m_time = time;
+    glBindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+    // the time changes every frame anyway so the whole block is rewritten, it is only 80 bytes
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &m_block);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, m_UBO);
+}
@@ -0,0 +1,33 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// binding point of the "Frame" uniform block, ResourceManager connects every program it loads to it
+const unsigned int FRAME_UNIFORM_BINDING = 0;
+
+// mirrors the std140 layout of the "Frame" block declared in the shaders, which pads the block to 16 bytes
+struct FrameBlock {
+    glm::mat4 m_projection;
+    float m_time;
+    float m_padding[3];
+};
+
+// owns the uniform buffer behind the "Frame" block. setters only touch the CPU copy,
+// beginFrame() uploads it with the new time and binds the buffer for the whole frame
+class FrameUniforms {
+public:
+    static void init();
+    static void clear();
+
+    static void setProjection(const glm::mat4& projection);
+    static void beginFrame(float time);
+private:
+    FrameUniforms() {}
+
+    static unsigned int m_UBO;
+    static FrameBlock m_block;
+};
+
+#endif
@@ -1,13 +1,14 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-
 #include "game_level.h"
+#include "collision.h"
 #include "powerup.h"
+#include "random.h"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 enum GameState {
     GAME_ACTIVE,
@@ -15,46 +16,59 @@ enum GameState {
     GAME_WIN
 };
 
-enum Direction {
-    UP,
-    RIGHT,
-    DOWN, 
-    LEFT
-};
-
-typedef std::tuple<bool, Direction, glm::vec2> Collision;
-
 const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
 const float PLAYER_VELOCITY(500.0f);
 const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
 const float BALL_RADIUS = 12.5f;
+const unsigned int DEFAULT_GAME_SEED = 1;
 
+// what the player does during one step. the held fields stay set while a key is down, the pressed fields are only
+// set for the first step after the key went down
+struct GameInput {
+    bool m_left, m_right;      // held, move the paddle
+    bool m_launch;             // held, releases a stuck ball
+    bool m_confirm;            // pressed, starts a level from the menu and leaves the win screen
+    bool m_nextLevel, m_previousLevel; // pressed, level selection in the menu
+};
+
+// rules, physics and level state of the game. nothing in here touches GL or a window, the same inputs, time steps
+// and seed always play out the same way. GameRenderer draws it
 class Game {
 public:
     GameState m_state;
-    bool m_keys[1024];
-    bool m_keysProcessed[1024];
     unsigned int m_width, m_height;
     std::vector<GameLevel> m_levels;
     std::vector<PowerUp> m_powerups;
     unsigned int m_level;
     unsigned int m_lives;
+    GameObject m_player;
+    BallObject m_ball;
+    // post-processing effects the rules switch on and off, the renderer applies them
+    bool m_confuse, m_chaos, m_shake;
+    float m_shakeTime;
+    // every random choice of the rules comes from here
+    Random m_random;
 
-    Game(unsigned int width, unsigned int height);
-    ~Game();
+    Game(unsigned int width, unsigned int height, unsigned int seed = DEFAULT_GAME_SEED);
 
+    // loads the levels relative to the working directory and places the paddle and ball
     void init();
 
-    void processInput(float dt);
+    // one simulation step, processInput() followed by update(). meant to run at a fixed dt, see FixedTimestep
+    void step(const GameInput& input, float dt);
+    void processInput(const GameInput& input, float dt);
     void update(float dt);
-    void render();
     void doCollisions();
 
     void resetLevel();
     void resetPlayer();
 
     void spawnPowerUps(GameObject& block);
+    void activatePowerUp(PowerUp& powerUp);
     void updatePowerUps(float dt);
+
+    // hook for scripted runs such as the golden image harness
+    void setPostEffects(bool confuse, bool chaos, bool shake);
 };
 
 #endif
\ No newline at end of file
@@ -1,14 +1,25 @@
 #include "game_level.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <sstream>
 
+const glm::vec3 BRICK_PALETTE[BRICK_PALETTE_SIZE] = {
+    glm::vec3(1.0f),
+    glm::vec3(0.8f, 0.8f, 0.7f),
+    glm::vec3(0.2f, 0.6f, 1.0f),
+    glm::vec3(0.0f, 0.7f, 0.0f),
+    glm::vec3(0.8f, 0.8f, 0.4f),
+    glm::vec3(1.0f, 0.5f, 0.0f)
+};
 
-void GameLevel::load(const char* file, unsigned int levelWidth, unsigned int levelHeight) {
-    this->m_bricks.clear();
+GameLevel::GameLevel()
+    : m_gridWidth(0), m_gridHeight(0), m_unitSize(0.0f), m_generation(0), m_solidBricks(0)
+{}
 
+void GameLevel::load(const char* file, unsigned int levelWidth, unsigned int levelHeight) {
     unsigned int tileCode;
-    GameLevel level;
     std::string line;
     std::ifstream fstream(file);
     std::vector<std::vector<unsigned int>> tileData;
@@ -21,18 +32,14 @@ void GameLevel::load(const char* file, unsigned int levelWidth, unsigned int lev
             }
             tileData.push_back(row);
         }
-        if (tileData.size() > 0) {
-            this->init(tileData, levelWidth, levelHeight);
-        }
     }
+    this->init(tileData, levelWidth, levelHeight);
 }
 
-void GameLevel::draw(SpriteRenderer& renderer) {
-    for (GameObject& tile : this->m_bricks) {
-        if (!tile.m_destroyed) {
-            tile.draw(renderer);
-        }
-    }
+void GameLevel::destroyBrick(unsigned int index) {
+    this->m_bricks[index].m_destroyed = true;
+    this->m_tiles[this->m_brickTile[index]] = 0;
+    this->m_destroyed.push_back(index);
 }
 
 bool GameLevel::isCompleted() {
@@ -45,34 +52,49 @@ bool GameLevel::isCompleted() {
 }
 
 void GameLevel::init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight) {
+    this->m_bricks.clear();
+    this->m_tiles.clear();
+    this->m_brickTile.clear();
+    this->m_destroyed.clear();
+    this->m_gridWidth = this->m_gridHeight = 0;
+    this->m_solidBricks = 0;
+    // unique across all levels and threads. a reloaded level can land in the storage of the one a renderer built from,
+    // so neither the address nor a per-level count tells them apart
+    static std::atomic<unsigned int> lastGeneration(0);
+    this->m_generation = ++lastGeneration;
+    if (tileData.empty()) {
+        return;
+    }
+
     unsigned int height = tileData.size();
     unsigned int width = tileData[0].size();
     float unit_width = levelWidth / static_cast<float>(width), unit_height = levelHeight / height;
 
+    this->m_gridWidth = width;
+    this->m_gridHeight = height;
+    this->m_unitSize = glm::vec2(unit_width, unit_height);
+    this->m_tiles.assign(width * height, 0);
+
     for (unsigned int y = 0; y < height; ++y) {
         for (unsigned int x = 0; x < width; ++x) {
-            if (tileData[y][x] == 1) {
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                GameObject obj(pos, size, ResourceManager::getTexture("block_solid"), glm::vec3(0.8f, 0.8f, 0.7f));
+            unsigned int code = tileData[y][x];
+            if (code == 0) {
+                continue;
+            }
+            glm::vec3 color = code < BRICK_PALETTE_SIZE ? BRICK_PALETTE[code] : glm::vec3(1.0f);
+            this->m_tiles[y * width + x] = std::min(code, 255u);
+            this->m_brickTile.push_back(y * width + x);
+
+            glm::vec2 pos(unit_width * x, unit_height * y);
+            glm::vec2 size(unit_width, unit_height);
+            if (code == 1) {
+                GameObject obj(pos, size, SPRITE_BLOCK_SOLID, color);
                 obj.m_isSolid = true;
                 this->m_bricks.push_back(obj);
-            } else if (tileData[y][x] > 1) {
-                glm::vec3 color = glm::vec3(1.0f);
-                if (tileData[y][x] == 2) {
-                    color = glm::vec3(0.2f, 0.6f, 1.0f);
-                } else if (tileData[y][x] == 3) {
-                    color = glm::vec3(0.0f, 0.7f, 0.0f);
-                } else if (tileData[y][x] == 4) {
-                    color = glm::vec3(0.8f, 0.8f, 0.4f);
-                } else if (tileData[y][x] == 5) {
-                    color = glm::vec3(1.0f, 0.5f, 0.0f);
-                }
-
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                this->m_bricks.push_back(GameObject(pos, size, ResourceManager::getTexture("block"), color));
+                ++this->m_solidBricks;
+            } else {
+                this->m_bricks.push_back(GameObject(pos, size, SPRITE_BLOCK, color));
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -3,23 +3,48 @@
 
 #include <vector>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "game_object.h"
-#include "sprite_renderer.h"
-#include "resource_manager.h"
 
+// brick colors indexed by tile code, codes past the end are drawn white
+const unsigned int BRICK_PALETTE_SIZE = 6;
+extern const glm::vec3 BRICK_PALETTE[BRICK_PALETTE_SIZE];
+
+// brick layout and state of one level, loaded from rows of tile codes. drawing is up to LevelRenderer, which
+// follows the changes through generation() and destroyedBricks() instead of the level knowing about any GL objects
 class GameLevel {
 public:
     std::vector<GameObject> m_bricks;
 
-    GameLevel() {}
+    GameLevel();
     void load(const char* file, unsigned int levelWidth, unsigned int levelHeight);
-    void draw(SpriteRenderer& renderer);
+    // builds the level from rows of tile codes as they appear in a .lvl file
+    void init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight);
+    void destroyBrick(unsigned int index);
     bool isCompleted();
+
+    // one tile code per grid cell in row-major order, 0 for empty cells and destroyed bricks
+    unsigned int gridWidth() const { return this->m_gridWidth; }
+    unsigned int gridHeight() const { return this->m_gridHeight; }
+    glm::vec2 unitSize() const { return this->m_unitSize; }
+    const std::vector<unsigned char>& tiles() const { return this->m_tiles; }
+    unsigned int brickTile(unsigned int index) const { return this->m_brickTile[index]; }
+
+    // changes with every init(), unique across all levels. 0 until the first init()
+    unsigned int generation() const { return this->m_generation; }
+    // indices of the bricks destroyed since the last init(), in the order they were destroyed
+    const std::vector<unsigned int>& destroyedBricks() const { return this->m_destroyed; }
+    // breakable bricks still standing, without scanning them
+    unsigned int remainingBricks() const { return this->m_bricks.size() - this->m_solidBricks - this->m_destroyed.size(); }
 private:
-    void init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight);
+    unsigned int m_gridWidth, m_gridHeight;
+    glm::vec2 m_unitSize;
+    std::vector<unsigned char> m_tiles;
+    std::vector<unsigned int> m_brickTile;
+    unsigned int m_generation;
+    std::vector<unsigned int> m_destroyed;
+    unsigned int m_solidBricks; // counted once in init()
 };
 
 #endif
\ No newline at end of file
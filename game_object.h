@@ -1,26 +1,40 @@
 #ifndef GAMEOBJECT_H
 #define GAMEOBJECT_H
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include "texture.h"
-#include "sprite_renderer.h"
+// the textures the game is drawn with, the objects' and the background. GameRenderer resolves each one to its texture
+// once, the objects themselves never touch GL
+enum Sprite {
+    SPRITE_NONE,
+    SPRITE_BLOCK,
+    SPRITE_BLOCK_SOLID,
+    SPRITE_PADDLE,
+    SPRITE_FACE,
+    SPRITE_POWERUP_SPEED,
+    SPRITE_POWERUP_STICKY,
+    SPRITE_POWERUP_PASSTHROUGH,
+    SPRITE_POWERUP_INCREASE,
+    SPRITE_POWERUP_CONFUSE,
+    SPRITE_POWERUP_CHAOS,
+    SPRITE_BACKGROUND,
+    SPRITE_COUNT
+};
 
 class GameObject {
 public:
     glm::vec2 m_position, m_size, m_velocity;
+    // where the last Game::step found the object, the renderer interpolates from here to m_position
+    glm::vec2 m_previousPosition;
     glm::vec3 m_color;
     float m_rotation;
     bool m_isSolid;
     bool m_destroyed;
 
-    Texture2D m_sprite;
+    Sprite m_sprite;
 
     GameObject();
-    GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
-
-    virtual void draw(SpriteRenderer& renderer);
+    GameObject(glm::vec2 pos, glm::vec2 size, Sprite sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
 };
 
 #endif
\ No newline at end of file
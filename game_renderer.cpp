@@ -0,0 +1,183 @@
+#include <string>
+
+#include "game_renderer.h"
+#include "resource_manager.h"
+#include "frame_uniforms.h"
+#include "gpu_profiler.h"
+#include "profiler.h"
+#include "trace.h"
+
+// ResourceManager names of the Sprite textures
+const char* SPRITE_TEXTURES[SPRITE_COUNT] = {
+    "", "block", "block_solid", "paddle", "face", "powerup_speed", "powerup_sticky", "powerup_passthrough",
+    "powerup_increase", "powerup_confuse", "powerup_chaos", "background"
+};
+
+GameRenderer::GameRenderer(unsigned int width, unsigned int height)
+    : m_showHud(false), m_width(width), m_height(height), m_stepTime(0.0f), m_sprites(nullptr), m_particles(nullptr), m_effects(nullptr),
+    m_text(nullptr), m_hud(nullptr), m_shownLives(0)
+{
+    this->m_renderSettings.m_samples = 4;
+    this->m_renderSettings.m_fxaa = false;
+    this->m_renderSettings.m_renderScale = 1.0f;
+    this->m_renderSettings.m_outputTexture = false;
+}
+
+GameRenderer::~GameRenderer() {
+    delete this->m_sprites;
+    delete this->m_particles;
+    delete this->m_effects;
+    delete this->m_hud;
+    delete this->m_text;
+}
+
+void GameRenderer::init(const Game& game, ParticleBackend particles) {
+    ResourceManager::loadShader("shaders/sprite.vs", "shaders/sprite.fs", nullptr, "sprite");
+    ResourceManager::loadShader("shaders/particle.vs", "shaders/particle.fs", nullptr, "particle");
+    ResourceManager::loadShader("shaders/tilemap.vs", "shaders/tilemap.fs", nullptr, "tilemap");
+
+    FrameUniforms::setProjection(glm::ortho(0.0f, static_cast<float>(this->m_width),
+        static_cast<float>(this->m_height), 0.0f, -1.0f, 1.0f));
+    ResourceManager::getShader("sprite").use().setInteger("image", 0);
+    ResourceManager::getShader("particle").use().setInteger("sprite", 0);
+
+    ResourceManager::loadTexture("textures/background.jpg", false, "background");
+    ResourceManager::loadTexture("textures/awesomeface.png", true, "face");
+    ResourceManager::loadTexture("textures/block.png", false, "block");
+    ResourceManager::loadTexture("textures/block_solid.png", false, "block_solid");
+    ResourceManager::loadTexture("textures/paddle.png", true, "paddle");
+    ResourceManager::loadTexture("textures/particle.png", true, "particle");
+    ResourceManager::loadTexture("textures/powerup_speed.png", true, "powerup_speed");
+    ResourceManager::loadTexture("textures/powerup_sticky.png", true, "powerup_sticky");
+    ResourceManager::loadTexture("textures/powerup_increase.png", true, "powerup_increase");
+    ResourceManager::loadTexture("textures/powerup_chaos.png", true, "powerup_chaos");
+    ResourceManager::loadTexture("textures/powerup_passthrough.png", true, "powerup_through");
+
+    // names that were never loaded stay at the empty texture, the same thing a lookup of them used to return
+    for (unsigned int i = 0; i < SPRITE_COUNT; ++i) {
+        std::map<std::string, Texture2D>::iterator texture = ResourceManager::m_textures.find(SPRITE_TEXTURES[i]);
+        if (texture != ResourceManager::m_textures.end()) {
+            this->m_textures[i] = texture->second;
+        }
+    }
+
+    this->m_sprites = new SpriteRenderer(ResourceManager::getShader("sprite"));
+    this->setParticleBackend(particles);
+    this->m_effects = new PostProcessor(this->m_width, this->m_height, this->m_renderSettings);
+    this->m_text = new TextRenderer();
+    this->m_text->load(FileSystem::getPath("fonts/OCRAEXT.TTF").c_str(), 24);
+    this->m_levels.assign(game.m_levels.size(), LevelRenderer());
+
+    this->m_shownLives = game.m_lives;
+    this->m_livesText = this->m_text->cacheText("Lives:" + std::to_string(this->m_shownLives), 5.0f, 5.0f, 1.0f);
+    this->m_startText = this->m_text->cacheText("Press ENTER to start", 250.0f, this->m_height / 2.0f, 1.0f);
+    this->m_selectText = this->m_text->cacheText("Press W or S to select level", 245.0f, this->m_height / 2.0f + 20.0f, 0.75f);
+    this->m_wonText = this->m_text->cacheText("You WON!!!", 320.0f, this->m_height / 2.0f - 20.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+    this->m_retryText = this->m_text->cacheText("Press ENTER to retry or ESC to quit", 130.0f, this->m_height / 2.0f, 1.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+    this->m_hud = new PerfHud(*this->m_sprites, *this->m_text, this->m_width - 316.0f, 5.0f);
+}
+
+void GameRenderer::update(const Game& game, float dt) {
+    ProfileScope scope(PHASE_PARTICLES);
+    this->m_stepTime = dt;
+    this->m_particles->update(dt, game.m_ball, 2, glm::vec2(game.m_ball.m_radius / 2.0f));
+}
+
+void GameRenderer::render(const Game& game, float alpha) {
+    TraceScope trace("GameRenderer::render");
+    this->m_hud->frame();
+    if (game.m_state == GAME_ACTIVE || game.m_state == GAME_MENU || game.m_state == GAME_WIN) {
+        GpuProfiler::begin(GPU_PASS_BACKGROUND);
+        this->m_effects->m_confuse = game.m_confuse;
+        this->m_effects->m_chaos = game.m_chaos;
+        this->m_effects->m_shake = game.m_shake;
+        this->m_effects->beginRender();
+        this->m_sprites->begin();
+        this->m_sprites->drawSprite(this->m_textures[SPRITE_BACKGROUND], glm::vec2(0.0f, 0.0f), glm::vec2(this->m_width, this->m_height), 0.0f);
+        // the level flushes the batch before its own draws anyway, flushing here only gives the background its own pass
+        this->m_sprites->flush();
+        GpuProfiler::begin(GPU_PASS_BRICKS);
+        this->m_levels[game.m_level].draw(game.m_levels[game.m_level], *this->m_sprites, this->m_textures);
+        GpuProfiler::begin(GPU_PASS_OBJECTS);
+        this->drawObject(game.m_player, alpha);
+
+        for (const PowerUp& powerUp : game.m_powerups) {
+            if (!powerUp.m_destroyed) {
+                this->drawObject(powerUp, alpha);
+            }
+        }
+        this->m_sprites->end();
+
+        GpuProfiler::begin(GPU_PASS_PARTICLES);
+        this->m_particles->draw((1.0f - alpha) * this->m_stepTime);
+        GpuProfiler::begin(GPU_PASS_BALL);
+        this->drawObject(game.m_ball, alpha);
+        GpuProfiler::begin(GPU_PASS_RESOLVE);
+        this->m_effects->endRender();
+        GpuProfiler::begin(GPU_PASS_POST);
+        this->m_effects->render();
+
+        GpuProfiler::begin(GPU_PASS_TEXT);
+        if (game.m_lives != this->m_shownLives) {
+            this->m_shownLives = game.m_lives;
+            this->m_text->setText(this->m_livesText, "Lives:" + std::to_string(this->m_shownLives));
+        }
+        this->m_text->drawText(this->m_livesText);
+        if (this->m_showHud) {
+            this->m_hud->draw(this->hudStats(game));
+        }
+    }
+    if (game.m_state == GAME_MENU) {
+        this->m_text->drawText(this->m_startText);
+        this->m_text->drawText(this->m_selectText);
+    }
+    if (game.m_state == GAME_WIN) {
+        this->m_text->drawText(this->m_wonText);
+        this->m_text->drawText(this->m_retryText);
+    }
+    this->m_text->flush();
+    GpuProfiler::end();
+}
+
+void GameRenderer::setLevelRenderMode(LevelRenderMode mode) {
+    for (LevelRenderer& level : this->m_levels) {
+        level.setRenderMode(mode);
+    }
+}
+
+void GameRenderer::setParticleBackend(ParticleBackend backend) {
+    delete this->m_particles;
+    this->m_particles = new ParticleGenerator(ResourceManager::getShader("particle"), ResourceManager::getTexture("particle"), 500,
+        backend);
+}
+
+ParticleBackend GameRenderer::particleBackend() const {
+    return this->m_particles->backend();
+}
+
+RenderSettings GameRenderer::settings() const {
+    return this->m_effects->settings();
+}
+
+void GameRenderer::setSettings(RenderSettings settings) {
+    this->m_effects->setSettings(settings);
+    this->m_renderSettings = this->m_effects->settings();
+}
+
+HudStats GameRenderer::hudStats(const Game& game) const {
+    HudStats stats = { this->m_particles->liveCount(), 0, game.m_levels[game.m_level].remainingBricks() };
+    for (const PowerUp& powerUp : game.m_powerups) {
+        stats.m_powerups += powerUp.m_activated;
+    }
+    return stats;
+}
+
+void GameRenderer::captureFrame(std::vector<unsigned char>& pixels) {
+    this->m_effects->readOutput(pixels);
+}
+
+void GameRenderer::drawObject(const GameObject& object, float alpha) {
+    glm::vec2 position = glm::mix(object.m_previousPosition, object.m_position, alpha);
+    this->m_sprites->drawSprite(this->m_textures[object.m_sprite], position, object.m_size,
+        object.m_rotation, object.m_color);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef GAME_RENDERER_H
+#define GAME_RENDERER_H
+
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "game.h"
+#include "sprite_renderer.h"
+#include "particle_generator.h"
+#include "post_processor.h"
+#include "text_renderer.h"
+#include "level_renderer.h"
+#include "perf_hud.h"
+
+// draws a Game. owns every GL object of the scene: the sprite, particle, text and post-processing renderers,
+// the overlay and one LevelRenderer per level. it only reads the game, apart from the particles it keeps no state
+// the rules depend on
+class GameRenderer {
+public:
+    RenderSettings m_renderSettings;
+    bool m_showHud;
+
+    GameRenderer(unsigned int width, unsigned int height);
+    ~GameRenderer();
+
+    // loads the shaders, textures and font relative to the working directory, needs a current GL context
+    void init(const Game& game, ParticleBackend particles = PARTICLES_CPU);
+    // advances the particle trail behind the ball, call after every game step with the same dt
+    void update(const Game& game, float dt);
+    // alpha blends the moving objects between the last two steps, see FixedTimestep::alpha()
+    void render(const Game& game, float alpha = 1.0f);
+
+    // forces every level into one render mode, LEVEL_RENDER_AUTO picks per level again
+    void setLevelRenderMode(LevelRenderMode mode);
+    // replaces the ball trail with an empty one advanced by the given backend
+    void setParticleBackend(ParticleBackend backend);
+    ParticleBackend particleBackend() const;
+    RenderSettings settings() const;
+    void setSettings(RenderSettings settings);
+    HudStats hudStats(const Game& game) const;
+    void captureFrame(std::vector<unsigned char>& pixels);
+private:
+    unsigned int m_width, m_height;
+    float m_stepTime; // dt of the last update()
+    SpriteRenderer* m_sprites;
+    ParticleGenerator* m_particles;
+    PostProcessor* m_effects;
+    TextRenderer* m_text;
+    PerfHud* m_hud;
+    std::vector<LevelRenderer> m_levels;
+    // indexed by Sprite, resolved once in init()
+    Texture2D m_textures[SPRITE_COUNT];
+
+    TextHandle m_livesText, m_startText, m_selectText, m_wonText, m_retryText;
+    unsigned int m_shownLives;
+
+    void drawObject(const GameObject& object, float alpha);
+};
+
+#endif
\ No newline at end of file
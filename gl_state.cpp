@@ -0,0 +1,108 @@
+#include "gl_state.h"
+
+const unsigned int UNKNOWN_STATE = 0xFFFFFFFF;
+
+// instantiate static variables
+unsigned int GLState::m_program = UNKNOWN_STATE;
+unsigned int GLState::m_activeUnit = UNKNOWN_STATE;
+unsigned int GLState::m_textures[GL_STATE_TEXTURE_UNITS] = {
+    UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE,
+    UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE, UNKNOWN_STATE
+};
+unsigned int GLState::m_vertexArray = UNKNOWN_STATE;
+unsigned int GLState::m_arrayBuffer = UNKNOWN_STATE;
+unsigned int GLState::m_blendSrc = UNKNOWN_STATE;
+unsigned int GLState::m_blendDst = UNKNOWN_STATE;
+unsigned int GLState::m_drawFramebuffer = UNKNOWN_STATE;
+unsigned int GLState::m_readFramebuffer = UNKNOWN_STATE;
+GLStateCounters GLState::m_counters = { 0, 0, 0 };
+GLStateCounters GLState::m_lastFrame = { 0, 0, 0 };
+
+bool GLState::changed(unsigned int& current, unsigned int value) {
+    if (current == value) {
+        ++m_counters.m_skipped;
+        return false;
+    }
+    current = value;
+    ++m_counters.m_issued;
+    return true;
+}
+
+void GLState::useProgram(unsigned int program) {
+    if (changed(m_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLState::activeTexture(unsigned int unit) {
+    if (changed(m_activeUnit, unit)) {
+        glActiveTexture(unit);
+    }
+}
+
+void GLState::bindTexture(unsigned int texture) {
+    unsigned int index = m_activeUnit - GL_TEXTURE0;
+    if (index >= GL_STATE_TEXTURE_UNITS) { // active unit unknown
+        activeTexture(GL_TEXTURE0);
+        index = 0;
+    }
+    if (changed(m_textures[index], texture)) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+}
+
+void GLState::bindVertexArray(unsigned int VAO) {
+    if (changed(m_vertexArray, VAO)) {
+        glBindVertexArray(VAO);
+    }
+}
+
+void GLState::bindArrayBuffer(unsigned int VBO) {
+    if (changed(m_arrayBuffer, VBO)) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    }
+}
+
+void GLState::blendFunc(unsigned int sfactor, unsigned int dfactor) {
+    if (m_blendSrc == sfactor && m_blendDst == dfactor) {
+        ++m_counters.m_skipped;
+        return;
+    }
+    m_blendSrc = sfactor;
+    m_blendDst = dfactor;
+    ++m_counters.m_issued;
+    glBlendFunc(sfactor, dfactor);
+}
+
+void GLState::bindFramebuffer(unsigned int target, unsigned int FBO) {
+    if (target == GL_READ_FRAMEBUFFER) {
+        if (changed(m_readFramebuffer, FBO)) {
+            glBindFramebuffer(target, FBO);
+        }
+    } else if (target == GL_DRAW_FRAMEBUFFER) {
+        if (changed(m_drawFramebuffer, FBO)) {
+            glBindFramebuffer(target, FBO);
+        }
+    } else if (m_drawFramebuffer == FBO && m_readFramebuffer == FBO) {
+        ++m_counters.m_skipped;
+    } else {
+        m_drawFramebuffer = m_readFramebuffer = FBO;
+        ++m_counters.m_issued;
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    }
+}
+
+void GLState::invalidate() {
+    m_program = m_activeUnit = UNKNOWN_STATE;
+    for (unsigned int i = 0; i < GL_STATE_TEXTURE_UNITS; ++i) {
+        m_textures[i] = UNKNOWN_STATE;
+    }
+    m_vertexArray = m_arrayBuffer = UNKNOWN_STATE;
+    m_blendSrc = m_blendDst = UNKNOWN_STATE;
+    m_drawFramebuffer = m_readFramebuffer = UNKNOWN_STATE;
+}
+
+void GLState::beginFrame() {
+    m_lastFrame = m_counters;
+    m_counters.m_issued = m_counters.m_skipped = m_counters.m_draws = 0;
+}
\ No newline at end of file
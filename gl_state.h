@@ -0,0 +1,51 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+const unsigned int GL_STATE_TEXTURE_UNITS = 16;
+
+struct GLStateCounters {
+    unsigned int m_issued;
+    unsigned int m_skipped;
+    unsigned int m_draws;
+};
+
+// shadows the bindings that the render paths change most often and drops calls that would not change them.
+// every bind of these kinds has to go through here, call invalidate() after deleting bound objects
+class GLState {
+public:
+    static void useProgram(unsigned int program);
+    static void activeTexture(unsigned int unit);
+    static void bindTexture(unsigned int texture);
+    static void bindVertexArray(unsigned int VAO);
+    static void bindArrayBuffer(unsigned int VBO);
+    static void blendFunc(unsigned int sfactor, unsigned int dfactor);
+    static void bindFramebuffer(unsigned int target, unsigned int FBO);
+
+    static void invalidate();
+    // draw calls do not go through here, every call site reports itself so the counters include them
+    static void countDraw() { ++m_counters.m_draws; }
+
+    // moves the running counters into lastFrame() and starts counting the next frame
+    static void beginFrame();
+    static GLStateCounters lastFrame() { return m_lastFrame; }
+    static GLStateCounters currentFrame() { return m_counters; }
+private:
+    GLState() {}
+
+    static unsigned int m_program;
+    static unsigned int m_activeUnit;
+    static unsigned int m_textures[GL_STATE_TEXTURE_UNITS];
+    static unsigned int m_vertexArray;
+    static unsigned int m_arrayBuffer;
+    static unsigned int m_blendSrc, m_blendDst;
+    static unsigned int m_drawFramebuffer, m_readFramebuffer;
+
+    static GLStateCounters m_counters;
+    static GLStateCounters m_lastFrame;
+
+    static bool changed(unsigned int& current, unsigned int value);
+};
+
+#endif
\ No newline at end of file
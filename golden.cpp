@@ -0,0 +1,352 @@
+#include "golden.h"
+#include "gl_state.h"
+#include "frame_uniforms.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+const float GOLDEN_FRAME_TIME = 1.0f / 60.0f;
+const unsigned int GOLDEN_ACTIVE_FRAMES = 90;
+const unsigned int GOLDEN_SEED = 1337;
+// play continued in tilemap mode, long enough for bricks to break after the tile texture was uploaded
+const unsigned int GOLDEN_TILEMAP_FRAMES = 60;
+
+// post-processing states rendered on top of the mid-level frame without advancing the game
+struct GoldenEffect {
+    const char* m_name;
+    bool m_confuse, m_chaos, m_shake;
+};
+
+const GoldenEffect GOLDEN_EFFECTS[] = {
+    { "confuse", true, false, false },
+    { "chaos", false, true, false },
+    { "shake", false, false, true }
+};
+
+GoldenHarness::GoldenHarness(Game& game, GameRenderer& renderer, const std::string& directory, unsigned int tolerance)
+    : m_game(game), m_renderer(renderer), m_directory(directory), m_tolerance(tolerance), m_frame(0)
+{}
+
+unsigned int GoldenHarness::run(bool record) {
+    if (record) {
+        std::error_code error;
+        std::filesystem::create_directories(this->m_directory, error);
+        if (error) {
+            std::cout << "ERROR::GOLDEN: Failed to create " << this->m_directory << ": " << error.message() << std::endl;
+            return 1;
+        }
+    }
+    // power-up drops depend on the seed, the particles start from their own fixed seed at init
+    this->m_game.m_random.seed(GOLDEN_SEED);
+    unsigned int failed = 0;
+
+    this->m_game.m_state = GAME_MENU;
+    this->step(1);
+    failed += !this->check("menu", record);
+
+    this->m_game.m_state = GAME_ACTIVE;
+    this->step(GOLDEN_ACTIVE_FRAMES);
+    failed += !this->check("active", record);
+
+    for (const GoldenEffect& effect : GOLDEN_EFFECTS) {
+        GLState::beginFrame();
+        FrameUniforms::beginFrame(this->m_frame * GOLDEN_FRAME_TIME);
+        this->m_game.setPostEffects(effect.m_confuse, effect.m_chaos, effect.m_shake);
+        this->m_renderer.render(this->m_game);
+        failed += !this->check(effect.m_name, record);
+    }
+    this->m_game.setPostEffects(false, false, false);
+
+    // the shipped levels are too small for LEVEL_RENDER_AUTO to pick the tilemap, so it is forced here. the first
+    // frame is the mid-level state again, rebuilt as a tilemap, the second one also covers bricks destroyed after that
+    this->m_renderer.setLevelRenderMode(LEVEL_RENDER_TILEMAP);
+    GLState::beginFrame();
+    FrameUniforms::beginFrame(this->m_frame * GOLDEN_FRAME_TIME);
+    this->m_renderer.render(this->m_game);
+    failed += !this->check("tilemap", record);
+    this->step(GOLDEN_TILEMAP_FRAMES);
+    failed += !this->check("tilemap_play", record);
+    this->m_renderer.setLevelRenderMode(LEVEL_RENDER_AUTO);
+
+    // the mid-level state once more from a fresh game with the transform feedback particles, they have to match the
+    // same reference as the CPU ones
+    ParticleBackend backend = this->m_renderer.particleBackend();
+    this->m_game = Game(this->m_game.m_width, this->m_game.m_height);
+    this->m_game.init();
+    this->m_game.m_random.seed(GOLDEN_SEED);
+    this->m_renderer.setParticleBackend(PARTICLES_GPU);
+    this->m_frame = 0;
+    this->m_game.m_state = GAME_MENU;
+    this->step(1);
+    this->m_game.m_state = GAME_ACTIVE;
+    this->step(GOLDEN_ACTIVE_FRAMES);
+    failed += !this->check("active_gpu_particles", "active", record);
+    this->m_renderer.setParticleBackend(backend);
+    return failed;
+}
+
+void GoldenHarness::step(unsigned int frames) {
+    for (unsigned int i = 0; i < frames; ++i, ++this->m_frame) {
+        GLState::beginFrame();
+        FrameUniforms::beginFrame(this->m_frame * GOLDEN_FRAME_TIME);
+
+        // launch is held throughout, it only does something once the level is active
+        GameInput input = {};
+        input.m_launch = true;
+        this->m_game.step(input, GOLDEN_FRAME_TIME);
+        this->m_renderer.update(this->m_game, GOLDEN_FRAME_TIME);
+        this->m_renderer.render(this->m_game);
+    }
+}
+
+bool GoldenHarness::check(const std::string& state, bool record) {
+    return this->check(state, state, record);
+}
+
+bool GoldenHarness::check(const std::string& state, const std::string& referenceState, bool record) {
+    std::vector<unsigned char> actual;
+    this->m_renderer.captureFrame(actual);
+    unsigned int width = this->m_game.m_width, height = this->m_game.m_height;
+    std::string reference = this->m_directory + "/" + referenceState + ".png";
+
+    // a state sharing another state's reference is compared against it even while recording
+    if (record && referenceState == state) {
+        if (!writePng(reference, width, height, actual)) {
+            std::cout << "ERROR::GOLDEN: Failed to write " << reference << std::endl;
+            return false;
+        }
+        std::cout << "recorded " << reference << std::endl;
+        return true;
+    }
+
+    int referenceWidth, referenceHeight, channels;
+    unsigned char* expected = stbi_load(reference.c_str(), &referenceWidth, &referenceHeight, &channels, 4);
+    if (!expected) {
+        std::cout << "ERROR::GOLDEN: Failed to load " << reference << std::endl;
+        return false;
+    }
+    if (referenceWidth != (int)width || referenceHeight != (int)height) {
+        std::cout << "FAIL " << state << ": reference is " << referenceWidth << "x" << referenceHeight
+            << ", frame is " << width << "x" << height << std::endl;
+        stbi_image_free(expected);
+        return false;
+    }
+
+    // failing pixels are red in the diff, matching ones a dimmed copy of the reference
+    std::vector<unsigned char> diff(actual.size());
+    unsigned int mismatches = 0, maxError = 0;
+    for (unsigned int i = 0; i < actual.size(); i += 4) {
+        unsigned int error = 0;
+        for (unsigned int c = 0; c < 4; ++c) {
+            error = std::max(error, (unsigned int)std::abs(actual[i + c] - expected[i + c]));
+        }
+        maxError = std::max(maxError, error);
+        bool mismatch = error > this->m_tolerance;
+        mismatches += mismatch;
+        diff[i] = mismatch ? 255 : expected[i] / 4;
+        diff[i + 1] = mismatch ? 0 : expected[i + 1] / 4;
+        diff[i + 2] = mismatch ? 0 : expected[i + 2] / 4;
+        diff[i + 3] = 255;
+    }
+    stbi_image_free(expected);
+
+    if (mismatches == 0) {
+        std::cout << "pass " << state << " (max channel error " << maxError << ")" << std::endl;
+        return true;
+    }
+    std::cout << "FAIL " << state << ": " << mismatches << " pixels differ by more than " << this->m_tolerance
+        << " (max " << maxError << ")" << std::endl;
+    writePng(this->m_directory + "/" + state + "_actual.png", width, height, actual);
+    writePng(this->m_directory + "/" + state + "_diff.png", width, height, diff);
+    return false;
+}
+
+static unsigned int crc32(unsigned int crc, const unsigned char* data, size_t length) {
+    static unsigned int table[256] = { 0 };
+    if (table[1] == 0) {
+        for (unsigned int n = 0; n < 256; ++n) {
+            unsigned int c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void appendBigEndian(std::vector<unsigned char>& out, unsigned int value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> chunk;
+    appendBigEndian(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    appendBigEndian(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+    file.write((const char*)chunk.data(), chunk.size());
+}
+
+// deflate bit stream, bits are appended from the least significant end of each byte
+struct BitWriter {
+    std::vector<unsigned char>& m_out;
+    unsigned int m_buffer, m_count;
+
+    void write(unsigned int bits, unsigned int count) {
+        this->m_buffer |= bits << this->m_count;
+        this->m_count += count;
+        while (this->m_count >= 8) {
+            this->m_out.push_back(this->m_buffer & 0xff);
+            this->m_buffer >>= 8;
+            this->m_count -= 8;
+        }
+    }
+    // huffman codes go out most significant bit first
+    void writeCode(unsigned int code, unsigned int length) {
+        unsigned int reversed = 0;
+        for (unsigned int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        this->write(reversed, length);
+    }
+    void flush() {
+        if (this->m_count > 0) {
+            this->write(0, 8 - this->m_count);
+        }
+    }
+};
+
+const unsigned short LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const unsigned char LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const unsigned short DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+const unsigned char DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// literal/length symbol in the fixed huffman code of RFC 1951 3.2.6
+static void writeFixedSymbol(BitWriter& bits, unsigned int symbol) {
+    if (symbol < 144) {
+        bits.writeCode(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        bits.writeCode(0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        bits.writeCode(symbol - 256, 7);
+    } else {
+        bits.writeCode(0xc0 + symbol - 280, 8);
+    }
+}
+
+// one fixed huffman block with greedy LZ77 matches, a short hash chain is plenty for the large flat areas of a frame
+static void deflate(const std::vector<unsigned char>& raw, std::vector<unsigned char>& out) {
+    const unsigned int WINDOW = 32768, MIN_MATCH = 3, MAX_MATCH = 258, MAX_CHAIN = 16;
+    const unsigned int HASH_BITS = 15;
+    std::vector<int> head(1 << HASH_BITS, -1), previous(raw.size(), -1);
+    BitWriter bits = { out, 0, 0 };
+    bits.write(1, 1); // final block
+    bits.write(1, 2); // fixed huffman codes
+
+    size_t size = raw.size();
+    for (size_t i = 0; i < size;) {
+        unsigned int bestLength = 0, bestDistance = 0;
+        unsigned int hash = 0;
+        if (i + MIN_MATCH <= size) {
+            hash = ((raw[i] << 10) ^ (raw[i + 1] << 5) ^ raw[i + 2]) & ((1 << HASH_BITS) - 1);
+            int candidate = head[hash];
+            for (unsigned int chain = 0; candidate >= 0 && i - candidate <= WINDOW && chain < MAX_CHAIN; ++chain) {
+                unsigned int length = 0, limit = std::min<size_t>(MAX_MATCH, size - i);
+                while (length < limit && raw[candidate + length] == raw[i + length]) {
+                    ++length;
+                }
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = i - candidate;
+                }
+                candidate = previous[candidate];
+            }
+        }
+
+        unsigned int advance = bestLength >= MIN_MATCH ? bestLength : 1;
+        if (bestLength >= MIN_MATCH) {
+            unsigned int code = 28;
+            while (LENGTH_BASE[code] > bestLength) {
+                --code;
+            }
+            writeFixedSymbol(bits, 257 + code);
+            bits.write(bestLength - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+            code = 29;
+            while (DISTANCE_BASE[code] > bestDistance) {
+                --code;
+            }
+            bits.writeCode(code, 5);
+            bits.write(bestDistance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+        } else {
+            writeFixedSymbol(bits, raw[i]);
+        }
+
+        // every position covered by the match goes into the hash chains
+        for (size_t end = i + advance; i < end; ++i) {
+            if (i + MIN_MATCH <= size) {
+                hash = ((raw[i] << 10) ^ (raw[i + 1] << 5) ^ raw[i + 2]) & ((1 << HASH_BITS) - 1);
+                previous[i] = head[hash];
+                head[hash] = i;
+            }
+        }
+    }
+    writeFixedSymbol(bits, 256);
+    bits.flush();
+}
+
+bool writePng(const std::string& file, unsigned int width, unsigned int height, const std::vector<unsigned char>& pixels) {
+    std::ofstream stream(file, std::ios::binary);
+    if (!stream) {
+        return false;
+    }
+
+    std::vector<unsigned char> raw;
+    raw.reserve((width * 4 + 1) * height);
+    for (unsigned int y = 0; y < height; ++y) {
+        raw.push_back(0); // no row filter
+        raw.insert(raw.end(), pixels.begin() + y * width * 4, pixels.begin() + (y + 1) * width * 4);
+    }
+
+    std::vector<unsigned char> header;
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+    header.insert(header.end(), { 8, 6, 0, 0, 0 }); // 8-bit RGBA, no interlacing
+
+    // the references are committed, so the data is compressed rather than written as stored blocks
+    std::vector<unsigned char> data = { 0x78, 0x01 };
+    deflate(raw, data);
+    unsigned int a = 1, b = 0;
+    for (unsigned char byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(data, (b << 16) | a);
+
+    const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    stream.write((const char*)signature, sizeof(signature));
+    writeChunk(stream, "IHDR", header);
+    writeChunk(stream, "IDAT", data);
+    writeChunk(stream, "IEND", std::vector<unsigned char>());
+    return stream.good();
+}
\ No newline at end of file
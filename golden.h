@@ -0,0 +1,37 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "game_renderer.h"
+
+// drives the game through fixed scripted states (menu, mid-level play, every post-processing effect, the tilemap
+// level path and the GPU particle backend) at a fixed time step and compares each final frame against
+// <directory>/<state>.png. a channel may differ by at most tolerance, failing states also get <state>_actual.png and
+// <state>_diff.png written next to the reference.
+// needs a context whose PostProcessor renders into its output texture, see RenderSettings::m_outputTexture
+class GoldenHarness {
+public:
+    GoldenHarness(Game& game, GameRenderer& renderer, const std::string& directory, unsigned int tolerance);
+
+    // record writes the references instead of comparing and creates the directory if needed, returns the number of
+    // failed states
+    unsigned int run(bool record);
+private:
+    Game& m_game;
+    GameRenderer& m_renderer;
+    std::string m_directory;
+    unsigned int m_tolerance;
+    unsigned int m_frame;
+
+    void step(unsigned int frames);
+    bool check(const std::string& state, bool record);
+    bool check(const std::string& state, const std::string& referenceState, bool record);
+};
+
+// writes 8-bit RGBA rows top to bottom as an uncompressed PNG
+bool writePng(const std::string& file, unsigned int width, unsigned int height, const std::vector<unsigned char>& pixels);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "gpu_profiler.h"
+
+#include <iomanip>
+#include <iostream>
+
+const char* GPU_PASS_NAMES[GPU_PASS_COUNT] = {
+    "background", "bricks", "objects", "particles", "ball", "resolve", "post", "text"
+};
+
+// instantiate static variables
+bool GpuProfiler::m_enabled = false;
+unsigned int GpuProfiler::m_queries[GPU_PROFILER_FRAMES][GPU_PASS_COUNT] = {};
+bool GpuProfiler::m_issued[GPU_PROFILER_FRAMES][GPU_PASS_COUNT] = {};
+unsigned int GpuProfiler::m_frame = 0;
+bool GpuProfiler::m_firstFrame = true;
+int GpuProfiler::m_activePass = -1;
+GLuint64 GpuProfiler::m_times[GPU_PASS_COUNT] = {};
+unsigned int GpuProfiler::m_dropped = 0;
+unsigned int GpuProfiler::m_logInterval = 0;
+unsigned int GpuProfiler::m_logFrames = 0;
+GLuint64 GpuProfiler::m_logTotals[GPU_PASS_COUNT] = {};
+
+void GpuProfiler::init() {
+    glGenQueries(GPU_PROFILER_FRAMES * GPU_PASS_COUNT, &m_queries[0][0]);
+}
+
+void GpuProfiler::clear() {
+    glDeleteQueries(GPU_PROFILER_FRAMES * GPU_PASS_COUNT, &m_queries[0][0]);
+    m_activePass = -1;
+}
+
+void GpuProfiler::setEnabled(bool enabled) {
+    if (!enabled) {
+        end();
+    }
+    m_enabled = enabled;
+}
+
+void GpuProfiler::setLogInterval(unsigned int frames) {
+    m_logInterval = frames;
+    m_logFrames = 0;
+    for (GLuint64& total : m_logTotals) {
+        total = 0;
+    }
+}
+
+void GpuProfiler::beginFrame() {
+    if (!m_enabled) {
+        return;
+    }
+    end();
+    m_frame = (m_frame + 1) % GPU_PROFILER_FRAMES;
+    // the set about to be reused was issued GPU_PROFILER_FRAMES - 1 frames ago
+    if (!collect(m_frame)) {
+        ++m_dropped;
+    }
+    for (bool& issued : m_issued[m_frame]) {
+        issued = false;
+    }
+}
+
+void GpuProfiler::begin(GpuPass pass) {
+    if (!m_enabled) {
+        return;
+    }
+    end();
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_frame][pass]);
+    m_issued[m_frame][pass] = true;
+    m_activePass = pass;
+}
+
+void GpuProfiler::end() {
+    if (m_activePass < 0) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    m_activePass = -1;
+}
+
+GLuint64 GpuProfiler::frameTime() {
+    GLuint64 total = 0;
+    for (GLuint64 time : m_times) {
+        total += time;
+    }
+    return total;
+}
+
+const char* GpuProfiler::passName(GpuPass pass) {
+    return GPU_PASS_NAMES[pass];
+}
+
+bool GpuProfiler::collect(unsigned int frame) {
+    bool any = false;
+    for (unsigned int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+        any = any || m_issued[frame][pass];
+    }
+    if (!any) { // nothing was issued into this set yet
+        return true;
+    }
+
+    // queries finish in order, if the last one is available all of them are
+    for (int pass = GPU_PASS_COUNT - 1; pass >= 0; --pass) {
+        if (m_issued[frame][pass]) {
+            GLint available = 0;
+            glGetQueryObjectiv(m_queries[frame][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    for (unsigned int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+        m_times[pass] = 0;
+        if (m_issued[frame][pass]) {
+            glGetQueryObjectui64v(m_queries[frame][pass], GL_QUERY_RESULT, &m_times[pass]);
+        }
+    }
+    // the first measured frame pays for lazy shader compilation and uploads, some drivers also report a bogus
+    // start time for the very first query of a context, so it is never reported
+    if (m_firstFrame) {
+        m_firstFrame = false;
+        for (GLuint64& time : m_times) {
+            time = 0;
+        }
+        return true;
+    }
+
+    for (unsigned int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+        m_logTotals[pass] += m_times[pass];
+    }
+    if (m_logInterval > 0 && ++m_logFrames == m_logInterval) {
+        log();
+    }
+    return true;
+}
+
+void GpuProfiler::log() {
+    GLuint64 frame = 0;
+    // the fixed 3 digit format is put back afterwards so other std::cout users are unaffected
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(3) << "GPU ms/frame over " << m_logFrames << " frames:";
+    for (unsigned int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+        std::cout << " " << GPU_PASS_NAMES[pass] << " " << m_logTotals[pass] / 1e6 / m_logFrames;
+        frame += m_logTotals[pass];
+        m_logTotals[pass] = 0;
+    }
+    std::cout << " | total " << frame / 1e6 / m_logFrames << ", dropped " << m_dropped << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+    m_logFrames = 0;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <glad/glad.h>
+
+// phases of Game::render in submission order
+enum GpuPass {
+    GPU_PASS_BACKGROUND, // includes clearing the scene target
+    GPU_PASS_BRICKS,
+    GPU_PASS_OBJECTS,    // paddle and power-ups
+    GPU_PASS_PARTICLES,
+    GPU_PASS_BALL,
+    GPU_PASS_RESOLVE,    // MSAA resolve in PostProcessor::endRender
+    GPU_PASS_POST,       // post-processing quad
+    GPU_PASS_TEXT,
+    GPU_PASS_COUNT
+};
+
+// results are read this many frames after they were issued, so reading them never waits for the GPU
+const unsigned int GPU_PROFILER_FRAMES = 3;
+
+// GL_TIME_ELAPSED queries around each render pass, one query set per in-flight frame.
+// begin()/end() are no-ops while disabled, passes must not nest because only one elapsed query can be active
+class GpuProfiler {
+public:
+    static void init();
+    static void clear();
+
+    static void setEnabled(bool enabled);
+    static bool enabled() { return m_enabled; }
+    // prints the average of every pass to stdout each interval frames, 0 turns the log off
+    static void setLogInterval(unsigned int frames);
+
+    // collects the oldest frame's results if the GPU has finished them and moves on to its query set
+    static void beginFrame();
+    static void begin(GpuPass pass);
+    static void end();
+
+    // nanoseconds spent in the pass in the newest finished frame, 0 when it did not run
+    static GLuint64 passTime(GpuPass pass) { return m_times[pass]; }
+    static GLuint64 frameTime();
+    // frames whose results were still pending when their query set was needed again
+    static unsigned int droppedFrames() { return m_dropped; }
+    static const char* passName(GpuPass pass);
+private:
+    GpuProfiler() {}
+
+    static bool m_enabled;
+    static unsigned int m_queries[GPU_PROFILER_FRAMES][GPU_PASS_COUNT];
+    static bool m_issued[GPU_PROFILER_FRAMES][GPU_PASS_COUNT];
+    static unsigned int m_frame;
+    static bool m_firstFrame;
+    static int m_activePass;
+    static GLuint64 m_times[GPU_PASS_COUNT];
+    static unsigned int m_dropped;
+
+    static unsigned int m_logInterval;
+    static unsigned int m_logFrames;
+    static GLuint64 m_logTotals[GPU_PASS_COUNT];
+
+    static bool collect(unsigned int frame);
+    static void log();
+};
+
+#endif
\ No newline at end of file
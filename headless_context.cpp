@@ -0,0 +1,131 @@
+#include "headless_context.h"
+
+#include <glad/glad.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+#include <iostream>
+
+bool hasExtension(const char* extensions, const char* name) {
+    if (extensions == nullptr) {
+        return false;
+    }
+    size_t length = strlen(name);
+    for (const char* found = strstr(extensions, name); found != nullptr; found = strstr(found + length, name)) {
+        bool startsWord = found == extensions || found[-1] == ' ';
+        bool endsWord = found[length] == ' ' || found[length] == '\0';
+        if (startsWord && endsWord) {
+            return true;
+        }
+    }
+    return false;
+}
+
+HeadlessContext::HeadlessContext()
+    : m_display(EGL_NO_DISPLAY), m_surface(EGL_NO_SURFACE), m_context(EGL_NO_CONTEXT)
+{}
+
+HeadlessContext::~HeadlessContext() {
+    this->destroy();
+}
+
+EGLDisplay HeadlessContext::openDisplay() {
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay != nullptr) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+                return display;
+            }
+        }
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+        return display;
+    }
+    return EGL_NO_DISPLAY;
+}
+
+bool HeadlessContext::create(unsigned int width, unsigned int height) {
+    this->m_display = this->openDisplay();
+    if (this->m_display == EGL_NO_DISPLAY) {
+        std::cout << "ERROR::HEADLESS: Failed to initialize an EGL display" << std::endl;
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cout << "ERROR::HEADLESS: EGL display does not support desktop OpenGL" << std::endl;
+        return false;
+    }
+
+    bool surfaceless = hasExtension(eglQueryString(this->m_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(this->m_display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        std::cout << "ERROR::HEADLESS: No matching EGL config" << std::endl;
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    this->m_context = eglCreateContext(this->m_display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (this->m_context == EGL_NO_CONTEXT) {
+        std::cout << "ERROR::HEADLESS: Failed to create a GL 3.3 core context" << std::endl;
+        return false;
+    }
+
+    if (!surfaceless) {
+        const EGLint surfaceAttribs[] = {
+            EGL_WIDTH, static_cast<EGLint>(width),
+            EGL_HEIGHT, static_cast<EGLint>(height),
+            EGL_NONE
+        };
+        this->m_surface = eglCreatePbufferSurface(this->m_display, config, surfaceAttribs);
+        if (this->m_surface == EGL_NO_SURFACE) {
+            std::cout << "ERROR::HEADLESS: Failed to create a pbuffer surface" << std::endl;
+            return false;
+        }
+    }
+    if (!eglMakeCurrent(this->m_display, this->m_surface, this->m_surface, this->m_context)) {
+        std::cout << "ERROR::HEADLESS: Failed to make the context current" << std::endl;
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (this->m_display == EGL_NO_DISPLAY) {
+        return;
+    }
+    eglMakeCurrent(this->m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (this->m_surface != EGL_NO_SURFACE) {
+        eglDestroySurface(this->m_display, this->m_surface);
+    }
+    if (this->m_context != EGL_NO_CONTEXT) {
+        eglDestroyContext(this->m_display, this->m_context);
+    }
+    eglTerminate(this->m_display);
+    this->m_display = EGL_NO_DISPLAY;
+    this->m_surface = EGL_NO_SURFACE;
+    this->m_context = EGL_NO_CONTEXT;
+}
\ No newline at end of file
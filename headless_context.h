@@ -0,0 +1,25 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <EGL/egl.h>
+
+// GL 3.3 core context without a window for batch rendering on machines without a display.
+// prefers Mesa's surfaceless platform and falls back to a pbuffer on the default display,
+// the default framebuffer may not exist so everything has to be rendered into framebuffer objects
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // creates the context, makes it current and loads the GL functions through glad
+    bool create(unsigned int width, unsigned int height);
+    void destroy();
+private:
+    EGLDisplay m_display;
+    EGLSurface m_surface;
+    EGLContext m_context;
+
+    EGLDisplay openDisplay();
+};
+
+#endif
\ No newline at end of file
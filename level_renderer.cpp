@@ -0,0 +1,203 @@
+#include "level_renderer.h"
+#include "gl_state.h"
+
+#include <algorithm>
+#include <limits>
+
+const unsigned int NO_DIRTY_INSTANCE = std::numeric_limits<unsigned int>::max();
+
+LevelRenderer::LevelRenderer()
+    : m_renderMode(LEVEL_RENDER_AUTO), m_activeMode(LEVEL_RENDER_INSTANCED), m_rebuild(true), m_level(nullptr), m_generation(0), m_destroyedSeen(0),
+    m_instanceVBO(0), m_dirtyBegin(NO_DIRTY_INSTANCE), m_dirtyEnd(0), m_gridWidth(0), m_gridHeight(0), m_unitSize(0.0f),
+    m_tileTexture(0), m_tileVAO(0)
+{}
+
+void LevelRenderer::draw(const GameLevel& level, SpriteRenderer& renderer, const Texture2D* textures) {
+    if (this->m_rebuild || this->m_level != &level || this->m_generation != level.generation()) {
+        this->build(level, renderer, textures);
+    }
+    this->destroyBricks(level);
+    if (this->m_activeMode == LEVEL_RENDER_TILEMAP) {
+        this->drawTilemap(renderer, textures);
+    } else {
+        this->drawInstances(renderer);
+    }
+}
+
+void LevelRenderer::setRenderMode(LevelRenderMode mode) {
+    this->m_renderMode = mode;
+    this->m_rebuild = true;
+}
+
+void LevelRenderer::build(const GameLevel& level, SpriteRenderer& renderer, const Texture2D* textures) {
+    this->m_activeMode = this->m_renderMode;
+    if (this->m_activeMode == LEVEL_RENDER_AUTO) {
+        this->m_activeMode = level.m_bricks.size() >= TILEMAP_MIN_BRICKS ? LEVEL_RENDER_TILEMAP : LEVEL_RENDER_INSTANCED;
+    }
+
+    if (this->m_activeMode == LEVEL_RENDER_TILEMAP) {
+        this->buildTilemap(level);
+    } else {
+        this->buildInstances(level, renderer, textures);
+    }
+    this->m_dirtyBegin = NO_DIRTY_INSTANCE;
+    this->m_dirtyEnd = 0;
+    // the upload already left out every brick destroyed so far
+    this->m_level = &level;
+    this->m_generation = level.generation();
+    this->m_destroyedSeen = level.destroyedBricks().size();
+    this->m_rebuild = false;
+}
+
+void LevelRenderer::buildInstances(const GameLevel& level, SpriteRenderer& renderer, const Texture2D* textures) {
+    for (BrickGroup& group : this->m_groups) {
+        glDeleteVertexArrays(1, &group.m_VAO);
+    }
+    if (!this->m_groups.empty()) {
+        // the new arrays may get the deleted names back, the cached binding must not make their setup skip the bind
+        GLState::invalidate();
+    }
+    this->m_groups.clear();
+
+    // count the bricks per texture, groups are ordered by first use
+    std::vector<unsigned int> brickGroup(level.m_bricks.size());
+    for (unsigned int i = 0; i < level.m_bricks.size(); ++i) {
+        unsigned int group = 0;
+        while (group < this->m_groups.size() && this->m_groups[group].m_sprite != level.m_bricks[i].m_sprite) {
+            ++group;
+        }
+        if (group == this->m_groups.size()) {
+            BrickGroup newGroup;
+            newGroup.m_sprite = level.m_bricks[i].m_sprite;
+            newGroup.m_texture = textures[newGroup.m_sprite];
+            newGroup.m_VAO = 0;
+            newGroup.m_first = newGroup.m_count = 0;
+            this->m_groups.push_back(newGroup);
+        }
+        ++this->m_groups[group].m_count;
+        brickGroup[i] = group;
+    }
+
+    unsigned int first = 0;
+    for (BrickGroup& group : this->m_groups) {
+        group.m_first = first;
+        first += group.m_count;
+        group.m_count = 0;
+    }
+
+    this->m_instances.resize(level.m_bricks.size());
+    this->m_instanceIndex.resize(level.m_bricks.size());
+    for (unsigned int i = 0; i < level.m_bricks.size(); ++i) {
+        BrickGroup& group = this->m_groups[brickGroup[i]];
+        unsigned int instance = group.m_first + group.m_count++;
+
+        const GameObject& brick = level.m_bricks[i];
+        this->m_instances[instance].m_position = brick.m_position;
+        this->m_instances[instance].m_size = brick.m_destroyed ? glm::vec2(0.0f) : brick.m_size;
+        this->m_instances[instance].m_color = brick.m_color;
+        this->m_instances[instance].m_rotation = brick.m_rotation;
+        this->m_instanceIndex[i] = instance;
+    }
+
+    if (this->m_instanceVBO == 0) {
+        glGenBuffers(1, &this->m_instanceVBO);
+    }
+    GLState::bindArrayBuffer(this->m_instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, this->m_instances.size() * sizeof(SpriteInstance), this->m_instances.data(), GL_STATIC_DRAW);
+
+    for (BrickGroup& group : this->m_groups) {
+        group.m_VAO = renderer.createInstanceArray(this->m_instanceVBO, group.m_first);
+    }
+}
+
+void LevelRenderer::buildTilemap(const GameLevel& level) {
+    this->m_gridWidth = level.gridWidth();
+    this->m_gridHeight = level.gridHeight();
+    this->m_unitSize = level.unitSize();
+    if (level.tiles().empty()) {
+        return;
+    }
+    if (this->m_tileTexture == 0) {
+        glGenTextures(1, &this->m_tileTexture);
+        // the quad corners come from gl_VertexID, the vertex array only has to exist
+        glGenVertexArrays(1, &this->m_tileVAO);
+    }
+
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(this->m_tileTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, this->m_gridWidth, this->m_gridHeight, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, level.tiles().data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    this->m_tileShader = ResourceManager::getShader("tilemap");
+    this->m_tileShader.use();
+    this->m_tileShader.setInteger("tiles", 0);
+    this->m_tileShader.setInteger("block", 1);
+    this->m_tileShader.setInteger("solidBlock", 2);
+    glUniform3fv(this->m_tileShader.getUniformLocation("palette"), BRICK_PALETTE_SIZE, (const float*)BRICK_PALETTE);
+}
+
+// bricks destroyed since the last draw become single texel updates or zero-sized instances
+void LevelRenderer::destroyBricks(const GameLevel& level) {
+    const std::vector<unsigned int>& destroyed = level.destroyedBricks();
+    if (this->m_destroyedSeen == destroyed.size()) {
+        return;
+    }
+
+    if (this->m_activeMode == LEVEL_RENDER_TILEMAP) {
+        GLState::activeTexture(GL_TEXTURE0);
+        GLState::bindTexture(this->m_tileTexture);
+        for (unsigned int i = this->m_destroyedSeen; i < destroyed.size(); ++i) {
+            unsigned int tile = level.brickTile(destroyed[i]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, tile % this->m_gridWidth, tile / this->m_gridWidth, 1, 1,
+                GL_RED_INTEGER, GL_UNSIGNED_BYTE, &level.tiles()[tile]);
+        }
+    } else {
+        for (unsigned int i = this->m_destroyedSeen; i < destroyed.size(); ++i) {
+            unsigned int instance = this->m_instanceIndex[destroyed[i]];
+            this->m_instances[instance].m_size = glm::vec2(0.0f);
+            this->m_dirtyBegin = std::min(this->m_dirtyBegin, instance);
+            this->m_dirtyEnd = std::max(this->m_dirtyEnd, instance + 1);
+        }
+    }
+    this->m_destroyedSeen = destroyed.size();
+}
+
+void LevelRenderer::drawInstances(SpriteRenderer& renderer) {
+    if (this->m_dirtyBegin < this->m_dirtyEnd) {
+        GLState::bindArrayBuffer(this->m_instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, this->m_dirtyBegin * sizeof(SpriteInstance),
+            (this->m_dirtyEnd - this->m_dirtyBegin) * sizeof(SpriteInstance), this->m_instances.data() + this->m_dirtyBegin);
+        this->m_dirtyBegin = NO_DIRTY_INSTANCE;
+        this->m_dirtyEnd = 0;
+    }
+
+    for (BrickGroup& group : this->m_groups) {
+        renderer.drawInstances(group.m_VAO, group.m_texture, group.m_count);
+    }
+}
+
+void LevelRenderer::drawTilemap(SpriteRenderer& renderer, const Texture2D* textures) {
+    if (this->m_gridWidth == 0) {
+        return;
+    }
+
+    renderer.flush();
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    this->m_tileShader.use();
+    // the sprite batches bind their own textures to unit 0, so the tile texture goes back on right before the draw
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(this->m_tileTexture);
+    this->m_tileShader.setVector2f("unitSize", this->m_unitSize);
+    this->m_tileShader.setVector2f("levelSize", this->m_unitSize * glm::vec2(this->m_gridWidth, this->m_gridHeight));
+    GLState::activeTexture(GL_TEXTURE1);
+    textures[SPRITE_BLOCK].bind();
+    GLState::activeTexture(GL_TEXTURE2);
+    textures[SPRITE_BLOCK_SOLID].bind();
+    GLState::bindVertexArray(this->m_tileVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    GLState::countDraw();
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef LEVEL_RENDERER_H
+#define LEVEL_RENDERER_H
+
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "game_level.h"
+#include "sprite_renderer.h"
+#include "resource_manager.h"
+
+// instanced draws one sprite instance per brick, the tilemap draws the whole grid as a single quad from a tile texture.
+// auto picks the tilemap for levels with at least TILEMAP_MIN_BRICKS bricks
+enum LevelRenderMode {
+    LEVEL_RENDER_AUTO,
+    LEVEL_RENDER_INSTANCED,
+    LEVEL_RENDER_TILEMAP
+};
+
+const unsigned int TILEMAP_MIN_BRICKS = 1024;
+
+// contiguous run of bricks sharing a texture inside the level's instance buffer
+struct BrickGroup {
+    Sprite m_sprite;
+    Texture2D m_texture;
+    unsigned int m_VAO;
+    unsigned int m_first, m_count;
+};
+
+// GPU copy of one GameLevel. bricks are uploaded once into a static instance buffer grouped by texture. destroyed
+// bricks stay in the buffer with a zero size, so drawing costs one instanced draw per texture no matter how many
+// bricks are left. the buffers are rebuilt whenever it is handed a different level or the level's generation changes
+class LevelRenderer {
+public:
+    LevelRenderer();
+    // textures holds one texture per Sprite
+    void draw(const GameLevel& level, SpriteRenderer& renderer, const Texture2D* textures);
+    // takes effect with a rebuild on the next draw
+    void setRenderMode(LevelRenderMode mode);
+private:
+    LevelRenderMode m_renderMode;
+    LevelRenderMode m_activeMode;
+    bool m_rebuild;
+    // the level the buffers were built from
+    const GameLevel* m_level;
+    unsigned int m_generation;
+    // entries of GameLevel::destroyedBricks() already applied to the buffers
+    unsigned int m_destroyedSeen;
+
+    unsigned int m_instanceVBO;
+    std::vector<SpriteInstance> m_instances;
+    std::vector<unsigned int> m_instanceIndex;
+    std::vector<BrickGroup> m_groups;
+    // half-open range of instances changed since the last upload
+    unsigned int m_dirtyBegin, m_dirtyEnd;
+
+    unsigned int m_gridWidth, m_gridHeight;
+    glm::vec2 m_unitSize;
+    unsigned int m_tileTexture;
+    unsigned int m_tileVAO;
+    Shader m_tileShader;
+
+    void build(const GameLevel& level, SpriteRenderer& renderer, const Texture2D* textures);
+    void buildInstances(const GameLevel& level, SpriteRenderer& renderer, const Texture2D* textures);
+    void buildTilemap(const GameLevel& level);
+    void destroyBricks(const GameLevel& level);
+    void drawInstances(SpriteRenderer& renderer);
+    void drawTilemap(SpriteRenderer& renderer, const Texture2D* textures);
+};
+
+#endif
\ No newline at end of file
@@ -2,19 +2,219 @@
 #include <GLFW/glfw3.h>
 
 #include "game.h"
+#include "game_renderer.h"
 #include "resource_manager.h"
+#include "gl_state.h"
+#include "frame_uniforms.h"
+#include "gpu_profiler.h"
+#include "profiler.h"
+#include "trace.h"
+#include "file_system.h"
+#include "fixed_timestep.h"
 
+#ifdef BREAKOUT_EGL
+#include "headless_context.h"
+#include "golden.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
+void initGL();
+void readInput(GameInput& input);
+void consumePresses(GameInput& input);
+float stepGame(FixedTimestep& timestep, float frameTime, GameInput& input);
+void processClientKeys();
+int runWindowed();
+int runHeadless(unsigned int frames);
+int runGolden(const std::string& directory, bool record, unsigned int tolerance);
 
 const unsigned int SCREEN_WIDTH = 800;
 const unsigned int SCREEN_HEIGHT = 600;
+const unsigned int DEFAULT_HEADLESS_FRAMES = 600;
+const float HEADLESS_FRAME_TIME = 1.0f / 60.0f;
+const unsigned int DEFAULT_GOLDEN_TOLERANCE = 8;
+const unsigned int GPU_TIMER_LOG_INTERVAL = 120;
+const float DEFAULT_TICK_RATE = 120.0f;
+// longest stretch of game time a single frame catches up on, anything beyond it is dropped after a hitch
+const float MAX_CATCH_UP_TIME = 0.1f;
 
 Game breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
+GameRenderer renderer(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+// keys still down from a press that was already handed to the game
+bool keys[1024];
+bool keysProcessed[1024];
+
+std::string profileOutput = "profile";   // base name of the CPU profile files, relative to the resource directory
+std::string traceOutput = "trace.json";  // trace file written by the F6 capture, same base directory
+unsigned int traceFrames = 300;          // length of a trace capture
+float tickRate = DEFAULT_TICK_RATE;      // simulation steps per second, independent of the frame rate
+ParticleBackend particleBackend = PARTICLES_CPU;
 
 int main(int argc, char* argv[]) {
+    // --samples <0|2|4|8>, --fxaa and --render-scale <0.25..1> pick the initial anti-aliasing and scene resolution,
+    // --headless [--frames <n>] renders n frames without a window as fast as possible and reports the frame rate,
+    // --golden <dir> [--tolerance <n>] compares scripted frames against <dir>/*.png, --golden-record <dir> writes them,
+    // --gpu-timers measures every render pass with timer queries and logs the averages,
+    // --profile <base> writes the CPU phase percentiles to <base>.csv/.json at exit (F5 writes them at any time),
+    // --trace <file> [--trace-frames <n>] records a Chrome trace from startup through n frames (F6 starts one later),
+    // --hud starts with the performance overlay shown (F4 toggles it),
+    // --tick-rate <hz> steps the simulation at a fixed rate other than 120 Hz, e.g. 240,
+    // --gpu-particles advances the ball trail with transform feedback instead of on the CPU
+    bool headless = false;
+    unsigned int frames = DEFAULT_HEADLESS_FRAMES;
+    std::string goldenDirectory;
+    bool goldenRecord = false;
+    unsigned int tolerance = DEFAULT_GOLDEN_TOLERANCE;
+    bool gpuTimers = false;
+    bool profileAtExit = false;
+    bool traceAtStart = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) {
+            renderer.m_renderSettings.m_samples = std::atoi(argv[++i]);
+        } else if (arg == "--fxaa") {
+            renderer.m_renderSettings.m_fxaa = true;
+        } else if (arg == "--render-scale" && i + 1 < argc) {
+            renderer.m_renderSettings.m_renderScale = std::atof(argv[++i]);
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::atoi(argv[++i]);
+        } else if ((arg == "--golden" || arg == "--golden-record") && i + 1 < argc) {
+            goldenRecord = arg == "--golden-record";
+            goldenDirectory = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::atoi(argv[++i]);
+        } else if (arg == "--gpu-timers") {
+            gpuTimers = true;
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profileOutput = argv[++i];
+            profileAtExit = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceOutput = argv[++i];
+            traceAtStart = true;
+        } else if (arg == "--trace-frames" && i + 1 < argc) {
+            traceFrames = std::atoi(argv[++i]);
+        } else if (arg == "--hud") {
+            renderer.m_showHud = true;
+        } else if (arg == "--tick-rate" && i + 1 < argc) {
+            tickRate = std::max(1.0f, static_cast<float>(std::atof(argv[++i])));
+        } else if (arg == "--gpu-particles") {
+            particleBackend = PARTICLES_GPU;
+        }
+    }
+
+    if (traceAtStart) { // before init so the asset loads are part of it
+        Trace::start(traceOutput, traceFrames);
+    }
+    GpuProfiler::setEnabled(gpuTimers);
+    GpuProfiler::setLogInterval(gpuTimers ? GPU_TIMER_LOG_INTERVAL : 0);
+    int result;
+    if (!goldenDirectory.empty()) {
+        result = runGolden(goldenDirectory, goldenRecord, tolerance);
+    } else {
+        result = headless ? runHeadless(frames) : runWindowed();
+    }
+    if (profileAtExit) {
+        Profiler::dump(profileOutput);
+    }
+    Trace::stop();
+    return result;
+}
+
+void initGL() {
+    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glEnable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    FrameUniforms::init();
+    GpuProfiler::init();
+
+    // levels and assets are found relative to the repository root
+    FileSystem::chDir();
+    FileSystem::chDir();
+    breakout.init();
+    renderer.init(breakout, particleBackend);
+}
+
+// held keys map straight to the input. a press is taken from the keys once and then ignored until the key is released,
+// it stays in the input until a step consumed it, so frames that run no step do not lose it
+void readInput(GameInput& input) {
+    input.m_left = keys[GLFW_KEY_LEFT];
+    input.m_right = keys[GLFW_KEY_RIGHT];
+    input.m_launch = keys[GLFW_KEY_SPACE];
+
+    const int pressKeys[] = { GLFW_KEY_ENTER, GLFW_KEY_UP, GLFW_KEY_DOWN };
+    bool* pressed[] = { &input.m_confirm, &input.m_nextLevel, &input.m_previousLevel };
+    for (unsigned int i = 0; i < 3; ++i) {
+        if (keys[pressKeys[i]] && !keysProcessed[pressKeys[i]]) {
+            *pressed[i] = true;
+            keysProcessed[pressKeys[i]] = true;
+        }
+    }
+}
+
+void consumePresses(GameInput& input) {
+    input.m_confirm = input.m_nextLevel = input.m_previousLevel = false;
+}
+
+// runs the steps the frame time is owed and returns the alpha to render the frame with
+float stepGame(FixedTimestep& timestep, float frameTime, GameInput& input) {
+    unsigned int steps = timestep.advance(frameTime);
+    for (unsigned int i = 0; i < steps; ++i) {
+        breakout.step(input, timestep.stepTime());
+        renderer.update(breakout, timestep.stepTime());
+        consumePresses(input);
+    }
+    return timestep.alpha();
+}
+
+// keys that belong to the client rather than the game, none of them changes what the simulation does
+void processClientKeys() {
+    // F1 cycles the MSAA samples, F2 toggles FXAA and F3 cycles the internal render scale
+    RenderSettings settings = renderer.settings();
+    bool settingsChanged = false;
+    if (keys[GLFW_KEY_F1] && !keysProcessed[GLFW_KEY_F1]) {
+        settings.m_samples = settings.m_samples == 0 ? 2 : (settings.m_samples >= 8 ? 0 : settings.m_samples * 2);
+        keysProcessed[GLFW_KEY_F1] = true;
+        settingsChanged = true;
+    }
+    if (keys[GLFW_KEY_F2] && !keysProcessed[GLFW_KEY_F2]) {
+        settings.m_fxaa = !settings.m_fxaa;
+        keysProcessed[GLFW_KEY_F2] = true;
+        settingsChanged = true;
+    }
+    if (keys[GLFW_KEY_F3] && !keysProcessed[GLFW_KEY_F3]) {
+        settings.m_renderScale = settings.m_renderScale <= 0.5f ? 1.0f : settings.m_renderScale - 0.25f;
+        keysProcessed[GLFW_KEY_F3] = true;
+        settingsChanged = true;
+    }
+    if (settingsChanged) {
+        renderer.setSettings(settings);
+    }
+    // F4 toggles the performance overlay, F5 writes the CPU frame profile, F6 traces the next frames
+    if (keys[GLFW_KEY_F4] && !keysProcessed[GLFW_KEY_F4]) {
+        renderer.m_showHud = !renderer.m_showHud;
+        keysProcessed[GLFW_KEY_F4] = true;
+    }
+    if (keys[GLFW_KEY_F5] && !keysProcessed[GLFW_KEY_F5]) {
+        Profiler::dump(profileOutput);
+        keysProcessed[GLFW_KEY_F5] = true;
+    }
+    if (keys[GLFW_KEY_F6] && !keysProcessed[GLFW_KEY_F6]) {
+        Trace::start(traceOutput, traceFrames);
+        keysProcessed[GLFW_KEY_F6] = true;
+    }
+}
+
+int runWindowed() {
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -23,6 +223,8 @@ int main(int argc, char* argv[]) {
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
     glfwWindowHint(GLFW_RESIZABLE, false);
+    // the default framebuffer is multisampled too, it is used directly whenever no post-processing is needed
+    glfwWindowHint(GLFW_SAMPLES, renderer.m_renderSettings.m_samples);
 
     GLFWwindow* window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Breakout", nullptr, nullptr);
     glfwMakeContextCurrent(window);
@@ -35,47 +237,136 @@ int main(int argc, char* argv[]) {
     glfwSetKeyCallback(window, key_callback);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    breakout.init();
+    initGL();
 
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
+    FixedTimestep timestep(tickRate, MAX_CATCH_UP_TIME);
+    GameInput input = {};
 
     while (!glfwWindowShouldClose(window)) {
+        Trace::beginFrame();
+        ProfileScope frameScope(PHASE_FRAME);
+        TraceScope frameTrace("frame");
         float currentFrame = glfwGetTime();
         deltaTime =  currentFrame - lastFrame;
         lastFrame = currentFrame;
         glfwPollEvents();
+        GLState::beginFrame();
+        GpuProfiler::beginFrame();
+        FrameUniforms::beginFrame(currentFrame);
 
-        breakout.processInput(deltaTime);
-        breakout.update(deltaTime);
-
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        breakout.render();
-
+        {
+            ProfileScope scope(PHASE_INPUT);
+            processClientKeys();
+            readInput(input);
+        }
+        float alpha;
+        {
+            ProfileScope scope(PHASE_UPDATE);
+            alpha = stepGame(timestep, deltaTime, input);
+        }
+        {
+            ProfileScope scope(PHASE_RENDER);
+            renderer.render(breakout, alpha);
+        }
+        ProfileScope scope(PHASE_SWAP);
         glfwSwapBuffers(window);
     }
 
     ResourceManager::clear();
+    FrameUniforms::clear();
+    GpuProfiler::clear();
 
     glfwTerminate();
     return 0;
 }
 
+// plays the level with the ball launched, frames are HEADLESS_FRAME_TIME of game time apart and step the simulation at
+// the tick rate like the windowed loop does. the frames end up in PostProcessor's output texture
+int runHeadless(unsigned int frames) {
+#ifdef BREAKOUT_EGL
+    HeadlessContext context;
+    if (!context.create(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        return -1;
+    }
+
+    renderer.m_renderSettings.m_outputTexture = true;
+    initGL();
+    breakout.m_state = GAME_ACTIVE;
+    GameInput input = {};
+    input.m_launch = true;
+    FixedTimestep timestep(tickRate, MAX_CATCH_UP_TIME);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < frames; ++frame) {
+        Trace::beginFrame();
+        ProfileScope frameScope(PHASE_FRAME);
+        TraceScope frameTrace("frame");
+        GLState::beginFrame();
+        GpuProfiler::beginFrame();
+        FrameUniforms::beginFrame(frame * HEADLESS_FRAME_TIME);
+
+        float alpha;
+        {
+            ProfileScope scope(PHASE_UPDATE);
+            alpha = stepGame(timestep, HEADLESS_FRAME_TIME, input);
+        }
+        ProfileScope scope(PHASE_RENDER);
+        renderer.render(breakout, alpha);
+    }
+    glFinish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "rendered " << frames << " frames in " << seconds * 1000.0 << " ms ("
+        << frames / seconds << " fps) on " << glGetString(GL_RENDERER) << std::endl;
+
+    ResourceManager::clear();
+    FrameUniforms::clear();
+    GpuProfiler::clear();
+    return 0;
+#else
+    std::cout << "ERROR::HEADLESS: This build has no EGL support" << std::endl;
+    return -1;
+#endif
+}
+
+// renders the scripted golden states, references have to be recorded and compared with the same render settings
+int runGolden(const std::string& directory, bool record, unsigned int tolerance) {
+#ifdef BREAKOUT_EGL
+    HeadlessContext context;
+    if (!context.create(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        return -1;
+    }
+
+    renderer.m_renderSettings.m_outputTexture = true;
+    initGL();
+    GoldenHarness harness(breakout, renderer, directory, tolerance);
+    unsigned int failed = harness.run(record);
+    if (!record) {
+        std::cout << "golden images: " << failed << " failed on " << glGetString(GL_RENDERER) << std::endl;
+    }
+
+    ResourceManager::clear();
+    FrameUniforms::clear();
+    GpuProfiler::clear();
+    return failed ? 1 : 0;
+#else
+    std::cout << "ERROR::GOLDEN: This build has no EGL support" << std::endl;
+    return -1;
+#endif
+}
+
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode) {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     }
     if (key >= 0 && key < 1024) {
         if (action == GLFW_PRESS) {
-            breakout.m_keys[key] = true;
+            keys[key] = true;
         } else if (action == GLFW_RELEASE) {
-            breakout.m_keys[key] = false;
-            breakout.m_keysProcessed[key] = false;
+            keys[key] = false;
+            keysProcessed[key] = false;
         }
     }
 }
@@ -0,0 +1,23 @@
+#include "particle_emitter.h"
+
+ParticleEmitter::ParticleEmitter(unsigned int amount)
+    : m_particles(amount)
+{}
+
+void ParticleEmitter::update(float dt, const GameObject& object, unsigned int newParticles, glm::vec2 offset) {
+    for (unsigned int i = 0; i < newParticles; ++i) {
+        ParticleSpawn spawn = this->next(object, offset);
+        this->m_particles.spawn(spawn.m_position, spawn.m_velocity, spawn.m_color, PARTICLE_LIFE);
+    }
+    this->m_particles.update(dt);
+}
+
+ParticleSpawn ParticleEmitter::next(const GameObject& object, glm::vec2 offset) {
+    float random = ((int)this->m_random.below(100) - 50) / 10.0f;
+    float rColor = 0.5f + (this->m_random.below(100) / 100.0f);
+    ParticleSpawn spawn;
+    spawn.m_position = object.m_position + random + offset;
+    spawn.m_velocity = object.m_velocity * 0.1f;
+    spawn.m_color = glm::vec4(rColor, rColor, rColor, 1.0f);
+    return spawn;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef PARTICLE_EMITTER_H
+#define PARTICLE_EMITTER_H
+
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+#include "particle_pool.h"
+#include "random.h"
+
+const float PARTICLE_LIFE = 1.0f;
+
+// one particle of the trail behind an object, as it starts out
+struct ParticleSpawn {
+    glm::vec2 m_position;
+    glm::vec2 m_velocity;
+    glm::vec4 m_color;
+};
+
+// the GL-free half of ParticleGenerator. it picks where trail particles start and, for the CPU backend, simulates
+// them in m_particles. particles are only decoration, they draw from their own stream so they never change what the
+// game does
+class ParticleEmitter {
+public:
+    ParticlePool m_particles;
+
+    // a backend that keeps the particles elsewhere passes 0 and only uses next()
+    ParticleEmitter(unsigned int amount);
+    // spawns newParticles behind object into m_particles, then advances them by dt
+    void update(float dt, const GameObject& object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    ParticleSpawn next(const GameObject& object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+private:
+    Random m_random;
+};
+
+#endif
\ No newline at end of file
@@ -1,46 +1,98 @@
 #include "particle_generator.h"
+#include "resource_manager.h"
+#include "gl_state.h"
 
-ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount)
-    : m_shader(shader), m_texture(texture), m_amount(amount)
+#include <algorithm>
+#include <cstddef>
+
+ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, ParticleBackend backend)
+    : m_emitter(backend == PARTICLES_CPU ? amount : 0), m_amount(amount), m_backend(backend), m_shader(shader), m_texture(texture),
+    m_VAO(0), m_quadVBO(0), m_instanceVBO(0), m_dtLocation(-1), m_updateVAO(0), m_gpuVAO(0), m_stateVBO(), m_current(0),
+    m_spawnCursor(0), m_gpuLive(0), m_gpuDropped(0)
 {
-    this->init();
+    // the CPU backend creates its buffers on the first draw, so it can be updated without a GL context
+    if (this->m_backend == PARTICLES_GPU) {
+        this->init();
+        this->initGpu();
+    }
 }
 
-void ParticleGenerator::update(float dt, GameObject& object, unsigned int newParticles, glm::vec2 offset) {
-    for (unsigned int i = 0; i < newParticles; ++i) {
-        int unusedParticle = this->firstUnusedParticle();
-        this->respawnParticle(this->m_particles[unusedParticle], object, offset);
+ParticleGenerator::~ParticleGenerator() {
+    // a CPU generator that was never drawn owns no GL objects, which is what lets it run without a context
+    if (this->m_VAO == 0) {
+        return;
     }
+    glDeleteVertexArrays(1, &this->m_VAO);
+    glDeleteVertexArrays(1, &this->m_updateVAO);
+    glDeleteVertexArrays(1, &this->m_gpuVAO);
+    glDeleteBuffers(1, &this->m_quadVBO);
+    glDeleteBuffers(1, &this->m_instanceVBO);
+    glDeleteBuffers(2, this->m_stateVBO);
+    // a generator created after this one may get the names back while they still look bound
+    GLState::invalidate();
+}
 
-    for (unsigned int i = 0; i < this->m_amount; ++i) {
-        Particle& p = this->m_particles[i];
-        p.m_life -= dt;
-        if (p.m_life > 0.0f) {
-            p.m_position -= p.m_velocity * dt;
-            p.m_color.a -= dt * 2.5f;
+void ParticleGenerator::update(float dt, const GameObject& object, unsigned int newParticles, glm::vec2 offset) {
+    if (this->m_backend == PARTICLES_CPU) {
+        this->m_emitter.update(dt, object, newParticles, offset);
+        return;
+    }
+
+    for (unsigned int i = 0; i < newParticles; ++i) {
+        ParticleSpawn spawn = this->m_emitter.next(object, offset);
+        if (this->m_gpuLive + this->m_spawns.size() < this->m_amount) {
+            this->m_spawns.push_back({ spawn.m_position, spawn.m_velocity, spawn.m_color, PARTICLE_LIFE });
+        } else {
+            ++this->m_gpuDropped;
         }
     }
+    this->updateGpu(dt);
 }
 
-void ParticleGenerator::draw() {
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    this->m_shader.use();
-    for (Particle particle : this->m_particles) {
-        if (particle.m_life > 0.0f) {
-            this->m_shader.setVector2f("offset", particle.m_position);
-            this->m_shader.setVector4f("color", particle.m_color);
-            this->m_texture.bind();
-            glBindVertexArray(this->m_VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
-        }
+void ParticleGenerator::draw(float lag) {
+    if (this->m_backend == PARTICLES_GPU) {
+        this->drawGpu();
+        return;
+    }
+
+    if (this->m_VAO == 0) {
+        this->init();
+    }
+    this->m_instances.clear();
+    const ParticlePool& particles = this->m_emitter.m_particles;
+    for (unsigned int i = 0; i < particles.liveCount(); ++i) {
+        ParticleInstance instance;
+        // particles move against their velocity, see ParticlePool::update
+        instance.m_offset = particles.position(i) + particles.velocity(i) * lag;
+        instance.m_color = particles.color(i);
+        this->m_instances.push_back(instance);
+    }
+    if (this->m_instances.empty()) {
+        return;
     }
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::bindArrayBuffer(this->m_instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, this->m_amount * sizeof(ParticleInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, this->m_instances.size() * sizeof(ParticleInstance), this->m_instances.data());
+
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);
+    this->m_shader.use();
+    GLState::activeTexture(GL_TEXTURE0);
+    this->m_texture.bind();
+    GLState::bindVertexArray(this->m_VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, this->m_instances.size());
+    GLState::countDraw();
+}
+
+unsigned int ParticleGenerator::liveCount() const {
+    return this->m_backend == PARTICLES_GPU ? this->m_gpuLive : this->m_emitter.m_particles.liveCount();
+}
+
+unsigned int ParticleGenerator::droppedSpawns() const {
+    return this->m_backend == PARTICLES_GPU ? this->m_gpuDropped : this->m_emitter.m_particles.droppedSpawns();
 }
 
 void ParticleGenerator::init() {
-    unsigned int VBO;
     float particle_quad[] = {
         0.0f, 1.0f, 0.0f, 1.0f,
         1.0f, 0.0f, 1.0f, 0.0f,
@@ -51,46 +103,166 @@ void ParticleGenerator::init() {
         1.0f, 0.0f, 1.0f, 0.0f
     };
     glGenVertexArrays(1, &this->m_VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(this->m_VAO);
+    glGenBuffers(1, &this->m_quadVBO);
+    GLState::bindVertexArray(this->m_VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::bindArrayBuffer(this->m_quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(particle_quad), particle_quad, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glBindVertexArray(0);
 
-    for (unsigned int i = 0; i < this->m_amount; ++i) {
-        this->m_particles.push_back(Particle());
+    // per-instance offset and color, refilled with the live particles every frame
+    glGenBuffers(1, &this->m_instanceVBO);
+    GLState::bindArrayBuffer(this->m_instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, this->m_amount * sizeof(ParticleInstance), NULL, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, m_offset));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, m_color));
+    glVertexAttribDivisor(2, 1);
+
+    GLState::bindArrayBuffer(0);
+    GLState::bindVertexArray(0);
+
+    if (this->m_backend == PARTICLES_CPU) {
+        this->m_instances.reserve(this->m_amount);
     }
 }
 
-unsigned int lastUsedParticle = 0;
-unsigned int ParticleGenerator::firstUnusedParticle() {
-    for (unsigned int i = lastUsedParticle; i < this->m_amount; ++i) {
-        if (this->m_particles[i].m_life <= 0.0f) {
-            lastUsedParticle = i;
-            return i;
-        }
+// the GPU backend keeps the particles in two state buffers used as a ring, advanced by particle_update.vs
+// through transform feedback and drawn straight from the buffer with the same particle shader as the CPU path
+void ParticleGenerator::initGpu() {
+    // every GPU generator shares one update program
+    if (ResourceManager::m_shaders.find("particle_update") == ResourceManager::m_shaders.end()) {
+        ResourceManager::loadFeedbackShader("shaders/particle_update.vs",
+            { "outPosition", "outVelocity", "outColor", "outLife" }, "particle_update");
     }
+    this->m_updateShader = ResourceManager::getShader("particle_update");
+    this->m_updateShader.setFloat("fadeRate", PARTICLE_FADE_RATE, true);
+    this->m_dtLocation = this->m_updateShader.getUniformLocation("dt");
 
-    for (unsigned int i = 0; i < lastUsedParticle; ++i) {
-        if (this->m_particles[i].m_life <= 0.0f) {
-            lastUsedParticle = i;
-            return i;
+    glGenBuffers(2, this->m_stateVBO);
+    for (unsigned int i = 0; i < 2; ++i) {
+        GLState::bindArrayBuffer(this->m_stateVBO[i]);
+        glBufferData(GL_ARRAY_BUFFER, this->m_amount * sizeof(GpuParticle), NULL, GL_DYNAMIC_COPY);
+    }
+    GLState::bindArrayBuffer(0);
+
+    glGenVertexArrays(1, &this->m_updateVAO);
+    GLState::bindVertexArray(this->m_updateVAO);
+    for (unsigned int i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(i);
+    }
+
+    glGenVertexArrays(1, &this->m_gpuVAO);
+    GLState::bindVertexArray(this->m_gpuVAO);
+    GLState::bindArrayBuffer(this->m_quadVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    GLState::bindArrayBuffer(0);
+    GLState::bindVertexArray(0);
+
+    this->m_spawns.reserve(this->m_amount);
+}
+
+void ParticleGenerator::updateGpu(float dt) {
+    unsigned int count = this->m_spawns.size();
+    if (count > 0) {
+        // spawn requests go right behind the newest live particle in the current state buffer
+        unsigned int head = std::min(count, this->m_amount - this->m_spawnCursor);
+        GLState::bindArrayBuffer(this->m_stateVBO[this->m_current]);
+        glBufferSubData(GL_ARRAY_BUFFER, this->m_spawnCursor * sizeof(GpuParticle), head * sizeof(GpuParticle), this->m_spawns.data());
+        if (head < count) {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, (count - head) * sizeof(GpuParticle), this->m_spawns.data() + head);
         }
+
+        this->m_spawnCursor = (this->m_spawnCursor + count) % this->m_amount;
+        this->m_gpuLive += count;
+        this->m_spawnBatches.push_back({ PARTICLE_LIFE, count });
+        this->m_spawns.clear();
+    }
+
+    for (SpawnBatch& batch : this->m_spawnBatches) {
+        batch.m_life -= dt;
+    }
+    while (!this->m_spawnBatches.empty() && this->m_spawnBatches.front().m_life <= 0.0f) {
+        this->m_gpuLive -= this->m_spawnBatches.front().m_count;
+        this->m_spawnBatches.pop_front();
+    }
+
+    unsigned int ranges[2][2];
+    unsigned int rangeCount = this->liveRanges(ranges);
+    if (rangeCount == 0) {
+        return;
+    }
+
+    this->m_updateShader.use();
+    this->m_updateShader.setFloat(this->m_dtLocation, dt);
+    glEnable(GL_RASTERIZER_DISCARD);
+    GLState::bindVertexArray(this->m_updateVAO);
+    GLState::bindArrayBuffer(this->m_stateVBO[this->m_current]);
+    for (unsigned int i = 0; i < rangeCount; ++i) {
+        size_t offset = ranges[i][0] * sizeof(GpuParticle);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(offset + offsetof(GpuParticle, m_position)));
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(offset + offsetof(GpuParticle, m_velocity)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(offset + offsetof(GpuParticle, m_color)));
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(offset + offsetof(GpuParticle, m_life)));
+
+        glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->m_stateVBO[1 - this->m_current], offset, ranges[i][1] * sizeof(GpuParticle));
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, ranges[i][1]);
+        GLState::countDraw();
+        glEndTransformFeedback();
+    }
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    this->m_current = 1 - this->m_current;
+}
+
+void ParticleGenerator::drawGpu() {
+    unsigned int ranges[2][2];
+    unsigned int rangeCount = this->liveRanges(ranges);
+    if (rangeCount == 0) {
+        return;
     }
 
-    lastUsedParticle = 0;
-    return 0;
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);
+    this->m_shader.use();
+    GLState::activeTexture(GL_TEXTURE0);
+    this->m_texture.bind();
+    GLState::bindVertexArray(this->m_gpuVAO);
+    GLState::bindArrayBuffer(this->m_stateVBO[this->m_current]);
+    for (unsigned int i = 0; i < rangeCount; ++i) {
+        size_t offset = ranges[i][0] * sizeof(GpuParticle);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(offset + offsetof(GpuParticle, m_position)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(offset + offsetof(GpuParticle, m_color)));
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, ranges[i][1]);
+        GLState::countDraw();
+    }
 }
 
-void ParticleGenerator::respawnParticle(Particle& particle, GameObject& object, glm::vec2 offset) {
-    float random = ((rand() % 100) - 50) / 10.0f;
-    float rColor = 0.5f + ((rand() % 100) / 100.0f);
-    particle.m_position = object.m_position + random + offset;
-    particle.m_color = glm::vec4(rColor, rColor, rColor, 1.0f);
-    particle.m_life = 1.0f;
-    particle.m_velocity = object.m_velocity * 0.1f;
+// the live particles are the most recent m_gpuLive spawns, which wrap around the end of the ring at most once
+unsigned int ParticleGenerator::liveRanges(unsigned int ranges[2][2]) const {
+    if (this->m_gpuLive == 0) {
+        return 0;
+    }
+    unsigned int first = (this->m_spawnCursor + this->m_amount - this->m_gpuLive) % this->m_amount;
+    if (first + this->m_gpuLive <= this->m_amount) {
+        ranges[0][0] = first;
+        ranges[0][1] = this->m_gpuLive;
+        return 1;
+    }
+    ranges[0][0] = first;
+    ranges[0][1] = this->m_amount - first;
+    ranges[1][0] = 0;
+    ranges[1][1] = this->m_gpuLive - ranges[0][1];
+    return 2;
 }
\ No newline at end of file
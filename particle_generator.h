@@ -1,6 +1,7 @@
 #ifndef PARTICLE_GENERATOR_H
 #define PARTICLE_GENERATOR_H
 
+#include <deque>
 #include <vector>
 
 #include <glad/glad.h>
@@ -9,31 +10,74 @@
 #include "shader.h"
 #include "texture.h"
 #include "game_object.h"
+#include "particle_emitter.h"
 
-struct Particle {
-    glm::vec2 m_position, m_velocity;
+enum ParticleBackend {
+    PARTICLES_CPU,
+    PARTICLES_GPU
+};
+
+struct ParticleInstance {
+    glm::vec2 m_offset;
+    glm::vec4 m_color;
+};
+
+// particle state as stored in the GPU backend's buffers, must match the particle_update.vs outputs
+struct GpuParticle {
+    glm::vec2 m_position;
+    glm::vec2 m_velocity;
     glm::vec4 m_color;
     float m_life;
+};
 
-    Particle() : m_position(0.0f), m_velocity(0.0f), m_color(1.0f), m_life(0.0f) {}
+// every particle lives exactly PARTICLE_LIFE, so the GPU backend tracks its live range per spawn batch
+// instead of reading the particles back
+struct SpawnBatch {
+    float m_life;
+    unsigned int m_count;
 };
 
 class ParticleGenerator {
 public:
-    ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
-    void update(float dt, GameObject& object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
-    void draw();
+    ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, ParticleBackend backend = PARTICLES_CPU);
+    ~ParticleGenerator();
+    void update(float dt, const GameObject& object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    // lag moves the CPU particles back along their velocity by that many seconds to match an interpolated frame,
+    // the GPU backend always draws its latest state
+    void draw(float lag = 0.0f);
+
+    ParticleBackend backend() const { return this->m_backend; }
+    unsigned int liveCount() const;
+    unsigned int droppedSpawns() const;
 private:
-    std::vector<Particle> m_particles;
+    ParticleEmitter m_emitter;
     unsigned int m_amount;
+    ParticleBackend m_backend;
 
     Shader m_shader;
     Texture2D m_texture;
     unsigned int m_VAO;
+    unsigned int m_quadVBO;
+    unsigned int m_instanceVBO;
+    std::vector<ParticleInstance> m_instances;
+
+    Shader m_updateShader;
+    int m_dtLocation;
+    unsigned int m_updateVAO, m_gpuVAO;
+    unsigned int m_stateVBO[2];
+    unsigned int m_current;
+    unsigned int m_spawnCursor;
+    unsigned int m_gpuLive;
+    unsigned int m_gpuDropped;
+    std::vector<GpuParticle> m_spawns;
+    std::deque<SpawnBatch> m_spawnBatches;
 
     void init();
-    unsigned int firstUnusedParticle();
-    void respawnParticle(Particle& particle, GameObject& object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    void initGpu();
+
+    void updateGpu(float dt);
+    void drawGpu();
+    unsigned int liveRanges(unsigned int ranges[2][2]) const;
 };
 
 #endif
\ No newline at end of file
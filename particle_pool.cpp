@@ -0,0 +1,130 @@
+#include "particle_pool.h"
+
+#if PARTICLE_SIMD_WIDTH == 8
+#include <immintrin.h>
+#elif PARTICLE_SIMD_WIDTH == 4
+#include <emmintrin.h>
+#endif
+
+ParticlePool::ParticlePool(unsigned int amount)
+    : m_amount(amount), m_alive(0), m_dropped(0)
+{
+    unsigned int padded = (amount + PARTICLE_SIMD_WIDTH - 1) / PARTICLE_SIMD_WIDTH * PARTICLE_SIMD_WIDTH;
+    this->m_positionX.assign(padded, 0.0f);
+    this->m_positionY.assign(padded, 0.0f);
+    this->m_velocityX.assign(padded, 0.0f);
+    this->m_velocityY.assign(padded, 0.0f);
+    this->m_alpha.assign(padded, 1.0f);
+    this->m_life.assign(padded, 0.0f);
+    this->m_color.assign(padded, glm::vec3(1.0f));
+}
+
+bool ParticlePool::spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life) {
+    if (this->m_alive == this->m_amount) {
+        ++this->m_dropped;
+        return false;
+    }
+
+    unsigned int index = this->m_alive++;
+    this->m_positionX[index] = position.x;
+    this->m_positionY[index] = position.y;
+    this->m_velocityX[index] = velocity.x;
+    this->m_velocityY[index] = velocity.y;
+    this->m_color[index] = glm::vec3(color.r, color.g, color.b);
+    this->m_alpha[index] = color.a;
+    this->m_life[index] = life;
+    return true;
+}
+
+// lanes that die this step keep their position and alpha because their deltas are masked to zero instead of branched around
+void ParticlePool::update(float dt) {
+#if PARTICLE_SIMD_WIDTH == 1
+    this->updateScalar(dt);
+#else
+    unsigned int count = (this->m_alive + PARTICLE_SIMD_WIDTH - 1) / PARTICLE_SIMD_WIDTH * PARTICLE_SIMD_WIDTH;
+    float* px = this->m_positionX.data();
+    float* py = this->m_positionY.data();
+    const float* vx = this->m_velocityX.data();
+    const float* vy = this->m_velocityY.data();
+    float* alpha = this->m_alpha.data();
+    float* life = this->m_life.data();
+
+#if PARTICLE_SIMD_WIDTH == 8
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vfade = _mm256_set1_ps(dt * PARTICLE_FADE_RATE);
+    const __m256 zero = _mm256_setzero_ps();
+    for (unsigned int i = 0; i < count; i += 8) {
+        __m256 l = _mm256_sub_ps(_mm256_loadu_ps(life + i), vdt);
+        _mm256_storeu_ps(life + i, l);
+        __m256 alive = _mm256_cmp_ps(l, zero, _CMP_GT_OQ);
+
+        __m256 dx = _mm256_and_ps(alive, _mm256_mul_ps(_mm256_loadu_ps(vx + i), vdt));
+        __m256 dy = _mm256_and_ps(alive, _mm256_mul_ps(_mm256_loadu_ps(vy + i), vdt));
+        _mm256_storeu_ps(px + i, _mm256_sub_ps(_mm256_loadu_ps(px + i), dx));
+        _mm256_storeu_ps(py + i, _mm256_sub_ps(_mm256_loadu_ps(py + i), dy));
+        _mm256_storeu_ps(alpha + i, _mm256_sub_ps(_mm256_loadu_ps(alpha + i), _mm256_and_ps(alive, vfade)));
+    }
+#else
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vfade = _mm_set1_ps(dt * PARTICLE_FADE_RATE);
+    const __m128 zero = _mm_setzero_ps();
+    for (unsigned int i = 0; i < count; i += 4) {
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), vdt);
+        _mm_storeu_ps(life + i, l);
+        __m128 alive = _mm_cmpgt_ps(l, zero);
+
+        __m128 dx = _mm_and_ps(alive, _mm_mul_ps(_mm_loadu_ps(vx + i), vdt));
+        __m128 dy = _mm_and_ps(alive, _mm_mul_ps(_mm_loadu_ps(vy + i), vdt));
+        _mm_storeu_ps(px + i, _mm_sub_ps(_mm_loadu_ps(px + i), dx));
+        _mm_storeu_ps(py + i, _mm_sub_ps(_mm_loadu_ps(py + i), dy));
+        _mm_storeu_ps(alpha + i, _mm_sub_ps(_mm_loadu_ps(alpha + i), _mm_and_ps(alive, vfade)));
+    }
+#endif
+
+    this->compact();
+#endif
+}
+
+void ParticlePool::updateScalar(float dt) {
+    for (unsigned int i = 0; i < this->m_alive; ++i) {
+        this->m_life[i] -= dt;
+        if (this->m_life[i] > 0.0f) {
+            this->m_positionX[i] -= this->m_velocityX[i] * dt;
+            this->m_positionY[i] -= this->m_velocityY[i] * dt;
+            this->m_alpha[i] -= dt * PARTICLE_FADE_RATE;
+        }
+    }
+
+    this->compact();
+}
+
+void ParticlePool::compact() {
+    unsigned int i = 0;
+    while (i < this->m_alive) {
+        if (this->m_life[i] > 0.0f) {
+            ++i;
+        } else {
+            this->move(--this->m_alive, i);
+        }
+    }
+}
+
+void ParticlePool::move(unsigned int from, unsigned int to) {
+    this->m_positionX[to] = this->m_positionX[from];
+    this->m_positionY[to] = this->m_positionY[from];
+    this->m_velocityX[to] = this->m_velocityX[from];
+    this->m_velocityY[to] = this->m_velocityY[from];
+    this->m_color[to] = this->m_color[from];
+    this->m_alpha[to] = this->m_alpha[from];
+    this->m_life[to] = this->m_life[from];
+}
+
+const char* ParticlePool::kernelName() {
+#if PARTICLE_SIMD_WIDTH == 8
+    return "avx";
+#elif PARTICLE_SIMD_WIDTH == 4
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef PARTICLE_POOL_H
+#define PARTICLE_POOL_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// structure-of-arrays particle storage, the arrays are padded to a multiple of PARTICLE_SIMD_WIDTH
+// so the update kernel never needs a scalar tail. live particles are kept in the prefix [0, liveCount()),
+// dead ones are swap-removed after every update so spawning is O(1) and iteration only touches live particles
+#if defined(__AVX__)
+#define PARTICLE_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64)
+#define PARTICLE_SIMD_WIDTH 4
+#else
+#define PARTICLE_SIMD_WIDTH 1
+#endif
+
+const float PARTICLE_FADE_RATE = 2.5f;
+
+class ParticlePool {
+public:
+    std::vector<float> m_positionX, m_positionY;
+    std::vector<float> m_velocityX, m_velocityY;
+    std::vector<float> m_alpha;
+    std::vector<float> m_life;
+    std::vector<glm::vec3> m_color;
+
+    ParticlePool(unsigned int amount);
+
+    unsigned int size() const { return this->m_amount; }
+    unsigned int liveCount() const { return this->m_alive; }
+    unsigned int droppedSpawns() const { return this->m_dropped; }
+    glm::vec2 position(unsigned int index) const { return glm::vec2(this->m_positionX[index], this->m_positionY[index]); }
+    glm::vec2 velocity(unsigned int index) const { return glm::vec2(this->m_velocityX[index], this->m_velocityY[index]); }
+    glm::vec4 color(unsigned int index) const { return glm::vec4(this->m_color[index], this->m_alpha[index]); }
+
+    // returns false and counts the request as dropped when the pool is exhausted
+    bool spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life);
+
+    void update(float dt);
+    void updateScalar(float dt);
+
+    static const char* kernelName();
+private:
+    unsigned int m_amount;
+    unsigned int m_alive;
+    unsigned int m_dropped;
+
+    void compact();
+    void move(unsigned int from, unsigned int to);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "perf_hud.h"
+#include "gl_state.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+const float HUD_LINE_HEIGHT = 16.0f;
+const float HUD_TEXT_SCALE = 0.5f;
+const float HUD_BAR_WIDTH = 2.0f;
+const float HUD_GRAPH_HEIGHT = 50.0f;
+const float HUD_GRAPH_MAX_MS = 100.0f / 3.0f; // a full-height bar is a 30 fps frame
+const float HUD_PADDING = 4.0f;
+const unsigned int HUD_LINE_CAPACITY = 48;
+
+PerfHud::PerfHud(SpriteRenderer& sprites, TextRenderer& text, float x, float y)
+    : m_sprites(sprites), m_text(text), m_x(x), m_y(y), m_lastFrame(0), m_frameTimes(), m_next(0),
+    m_intervalTotal(0.0f), m_intervalMax(0.0f), m_intervalFrames(0), m_shownAverage(0.0f), m_shownMax(0.0f), m_textDue(true)
+{
+    unsigned char white[] = { 255, 255, 255, 255 };
+    this->m_solid.m_internalFormat = GL_RGBA;
+    this->m_solid.m_imageFormat = GL_RGBA;
+    this->m_solid.generate(1, 1, white);
+
+    // the placeholder sizes the cached ranges so later updates never have to grow them
+    std::string placeholder(HUD_LINE_CAPACITY, '0');
+    for (unsigned int i = 0; i < 3; ++i) {
+        this->m_lines[i] = text.cacheText(placeholder, x + HUD_PADDING, y + HUD_PADDING + i * HUD_LINE_HEIGHT, HUD_TEXT_SCALE,
+            glm::vec3(1.0f, 1.0f, 0.6f));
+    }
+    this->m_buffer.reserve(HUD_LINE_CAPACITY);
+}
+
+void PerfHud::frame() {
+    unsigned long long now = Profiler::now();
+    if (this->m_lastFrame != 0) {
+        float ms = (now - this->m_lastFrame) / 1e6f;
+        this->m_frameTimes[this->m_next] = ms;
+        this->m_next = (this->m_next + 1) % HUD_GRAPH_FRAMES;
+
+        this->m_intervalTotal += ms;
+        this->m_intervalMax = std::max(this->m_intervalMax, ms);
+        ++this->m_intervalFrames;
+        if (this->m_intervalTotal >= HUD_TEXT_INTERVAL * 1000.0f) {
+            this->m_shownAverage = this->m_intervalTotal / this->m_intervalFrames;
+            this->m_shownMax = this->m_intervalMax;
+            this->m_intervalTotal = this->m_intervalMax = 0.0f;
+            this->m_intervalFrames = 0;
+            this->m_textDue = true;
+        }
+    }
+    this->m_lastFrame = now;
+}
+
+void PerfHud::draw(const HudStats& stats) {
+    // taken before the overlay issues anything of its own
+    GLStateCounters counters = GLState::currentFrame();
+
+    if (this->m_textDue) {
+        this->m_textDue = false;
+        float fps = this->m_shownAverage > 0.0f ? 1000.0f / this->m_shownAverage : 0.0f;
+        this->setLine(0, "%.2f ms  %.0f fps  max %.2f", this->m_shownAverage, fps, this->m_shownMax);
+        this->setLine(1, "draws %u  binds %u  skipped %u", counters.m_draws, counters.m_issued, counters.m_skipped);
+        this->setLine(2, "particles %u  powerups %u  bricks %u", stats.m_particles, stats.m_powerups, stats.m_bricks);
+    }
+
+    float graphY = this->m_y + 2.0f * HUD_PADDING + 3.0f * HUD_LINE_HEIGHT;
+    this->m_sprites.begin();
+    this->m_sprites.drawSprite(this->m_solid, glm::vec2(this->m_x, this->m_y),
+        glm::vec2(HUD_GRAPH_FRAMES * HUD_BAR_WIDTH + 2.0f * HUD_PADDING, graphY + HUD_GRAPH_HEIGHT + HUD_PADDING - this->m_y),
+        0.0f, glm::vec3(0.05f));
+    // oldest frame on the left
+    for (unsigned int i = 0; i < HUD_GRAPH_FRAMES; ++i) {
+        float ms = this->m_frameTimes[(this->m_next + i) % HUD_GRAPH_FRAMES];
+        float height = std::min(ms / HUD_GRAPH_MAX_MS, 1.0f) * HUD_GRAPH_HEIGHT;
+        glm::vec3 color = ms <= 17.0f ? glm::vec3(0.2f, 0.9f, 0.2f) : (ms <= 34.0f ? glm::vec3(1.0f, 0.8f, 0.1f) : glm::vec3(1.0f, 0.2f, 0.2f));
+        this->m_sprites.drawSprite(this->m_solid, glm::vec2(this->m_x + HUD_PADDING + i * HUD_BAR_WIDTH, graphY + HUD_GRAPH_HEIGHT - height),
+            glm::vec2(HUD_BAR_WIDTH, height), 0.0f, color);
+    }
+    this->m_sprites.end();
+
+    for (TextHandle line : this->m_lines) {
+        this->m_text.drawText(line);
+    }
+}
+
+void PerfHud::setLine(unsigned int line, const char* format, ...) {
+    char formatted[HUD_LINE_CAPACITY + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(formatted, sizeof(formatted), format, args);
+    va_end(args);
+    // assigning into the reserved buffer reuses its storage
+    this->m_buffer.assign(formatted);
+    this->m_text.setText(this->m_lines[line], this->m_buffer);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <string>
+
+#include "sprite_renderer.h"
+#include "text_renderer.h"
+
+const unsigned int HUD_GRAPH_FRAMES = 150;
+// the text only changes this often so it stays readable, the graph moves every frame
+const float HUD_TEXT_INTERVAL = 0.25f;
+
+// counts the game reports to the overlay each frame
+struct HudStats {
+    unsigned int m_particles;
+    unsigned int m_powerups;
+    unsigned int m_bricks;
+};
+
+// frame time, a rolling frame time graph and per-frame counters drawn over the finished frame.
+// the lines are cached TextRenderer strings and the graph is one batched sprite draw, nothing allocates after
+// the first update. GL counters are taken before the overlay draws so it does not count itself
+class PerfHud {
+public:
+    PerfHud(SpriteRenderer& sprites, TextRenderer& text, float x, float y);
+
+    // call once per frame whether or not the overlay is shown, so toggling it shows a warm graph
+    void frame();
+    void draw(const HudStats& stats);
+private:
+    SpriteRenderer& m_sprites;
+    TextRenderer& m_text;
+    Texture2D m_solid;
+    float m_x, m_y;
+
+    unsigned long long m_lastFrame;
+    float m_frameTimes[HUD_GRAPH_FRAMES]; // milliseconds, ring buffer
+    unsigned int m_next;
+
+    // averages over the current text interval and the values on screen
+    float m_intervalTotal, m_intervalMax;
+    unsigned int m_intervalFrames;
+    float m_shownAverage, m_shownMax;
+    bool m_textDue;
+
+    TextHandle m_lines[3];
+    std::string m_buffer;
+
+    void setLine(unsigned int line, const char* format, ...);
+};
+
+#endif
\ No newline at end of file
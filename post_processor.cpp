@@ -1,32 +1,66 @@
 #include "post_processor.h"
+#include "resource_manager.h"
+#include "gl_state.h"
+#include "trace.h"
 
+#include <algorithm>
 #include <iostream>
+#include <string>
 
-PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int height)
-    : m_postProcessingShader(shader), m_texture(), m_width(width), m_height(height), m_confuse(false), m_chaos(false), m_shake(false)
+PostProcessor::PostProcessor(unsigned int width, unsigned int height, RenderSettings settings)
+    : m_texture(), m_output(), m_width(width), m_height(height), m_confuse(false), m_chaos(false), m_shake(false),
+    m_settings(settings), m_windowSamples(0), m_sceneWidth(0), m_sceneHeight(0), m_offscreen(false), m_outputFBO(0)
 {
+    if (settings.m_outputTexture) {
+        glGenFramebuffers(1, &this->m_outputFBO);
+        GLState::bindFramebuffer(GL_FRAMEBUFFER, this->m_outputFBO);
+        this->m_output.generate(width, height, NULL);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->m_output.ID, 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::POSTPROCESSOR: Failed to initialize output FBO" << std::endl;
+        }
+    }
+    GLState::bindFramebuffer(GL_FRAMEBUFFER, this->m_outputFBO);
+    int windowSamples = 0;
+    glGetIntegerv(GL_SAMPLES, &windowSamples);
+    this->m_windowSamples = windowSamples;
+
     glGenFramebuffers(1, &this->MSFBO);
     glGenFramebuffers(1, &this->FBO);
     glGenRenderbuffers(1, &this->RBO);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
+    this->initRenderData();
+    for (unsigned int effects = 0; effects < POST_PERMUTATIONS; ++effects) {
+        if (!((effects & POST_CHAOS) && (effects & POST_CONFUSE))) { // chaos overrides confuse
+            this->permutation(effects);
+        }
     }
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
-    this->m_texture.generate(width, height, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->m_texture.ID, 0);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize FBO" << std::endl;
+    this->setSettings(settings);
+}
+
+Shader& PostProcessor::permutation(unsigned int effects) {
+    std::map<unsigned int, Shader>::iterator cached = this->m_permutations.find(effects);
+    if (cached != this->m_permutations.end()) {
+        return cached->second;
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    this->initRenderData();
-    this->m_postProcessingShader.setInteger("scene", 0, true);
+    std::string defines;
+    if (effects & POST_CHAOS) {
+        defines += "#define CHAOS\n";
+    }
+    if (effects & POST_CONFUSE) {
+        defines += "#define CONFUSE\n";
+    }
+    if (effects & POST_SHAKE) {
+        defines += "#define SHAKE\n";
+    }
+    if (effects & POST_FXAA) {
+        defines += "#define FXAA\n";
+    }
+    Shader shader = ResourceManager::loadShader("shaders/post_processing.vs", "shaders/post_processing.fs", nullptr,
+        "postprocessing" + std::to_string(effects), defines);
+
+    shader.setInteger("scene", 0, true);
     float offset = 1.0f / 300.0f;
     float offsets[9][2] = {
         { -offset,  offset  },  // top-left
@@ -39,46 +73,142 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
         {  0.0f,   -offset  },  // bottom-center
         {  offset, -offset  }   // bottom-right 
     };
-    glUniform2fv(glGetUniformLocation(this->m_postProcessingShader.ID, "offsets"), 9, (float*)offsets);
+    glUniform2fv(shader.getUniformLocation("offsets"), 9, (float*)offsets);
     int edge_kernel[9] = {
         -1, -1, -1,
         -1,  8, -1,
         -1, -1, -1
     };
-    glUniform1iv(glGetUniformLocation(this->m_postProcessingShader.ID, "edge_kernel"), 9, edge_kernel);
+    glUniform1iv(shader.getUniformLocation("edge_kernel"), 9, edge_kernel);
     float blur_kernel[9] = {
         1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
         2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
         1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
     };
-    glUniform1fv(glGetUniformLocation(this->m_postProcessingShader.ID, "blur_kernel"), 9, blur_kernel);
+    glUniform1fv(shader.getUniformLocation("blur_kernel"), 9, blur_kernel);
+
+    return this->m_permutations[effects] = shader;
+}
+
+void PostProcessor::setSettings(RenderSettings settings) {
+    int maxSamples = 0;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    settings.m_samples = std::min<unsigned int>(settings.m_samples, maxSamples);
+    settings.m_renderScale = std::max(MIN_RENDER_SCALE, std::min(settings.m_renderScale, 1.0f));
+    settings.m_outputTexture = this->m_outputFBO != 0;
+    this->m_settings = settings;
+
+    if (settings.m_samples > 0) {
+        glEnable(GL_MULTISAMPLE);
+    } else {
+        glDisable(GL_MULTISAMPLE);
+    }
+    this->initTargets();
+}
+
+void PostProcessor::initTargets() {
+    this->m_sceneWidth = std::max(1u, static_cast<unsigned int>(this->m_width * this->m_settings.m_renderScale));
+    this->m_sceneHeight = std::max(1u, static_cast<unsigned int>(this->m_height * this->m_settings.m_renderScale));
+
+    if (this->m_settings.m_samples > 0) {
+        GLState::bindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, this->m_settings.m_samples, GL_RGB, this->m_sceneWidth, this->m_sceneHeight);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
+        }
+    }
+
+    GLState::bindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+    this->m_texture.generate(this->m_sceneWidth, this->m_sceneHeight, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->m_texture.ID, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize FBO" << std::endl;
+    }
+    GLState::bindFramebuffer(GL_FRAMEBUFFER, this->m_outputFBO);
+
+    glm::vec2 texelSize(1.0f / this->m_sceneWidth, 1.0f / this->m_sceneHeight);
+    for (std::pair<const unsigned int, Shader>& permutation : this->m_permutations) {
+        if (permutation.first & POST_FXAA) {
+            permutation.second.use().setVector2f("texelSize", texelSize);
+        }
+    }
+}
+
+void PostProcessor::readOutput(std::vector<unsigned char>& pixels) {
+    unsigned int rowSize = this->m_width * 4;
+    pixels.resize(rowSize * this->m_height);
+    GLState::bindFramebuffer(GL_READ_FRAMEBUFFER, this->m_outputFBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, this->m_width, this->m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // GL returns the bottom row first
+    std::vector<unsigned char> row(rowSize);
+    for (unsigned int y = 0; y < this->m_height / 2; ++y) {
+        unsigned char* top = pixels.data() + y * rowSize;
+        unsigned char* bottom = pixels.data() + (this->m_height - 1 - y) * rowSize;
+        std::copy(top, top + rowSize, row.begin());
+        std::copy(bottom, bottom + rowSize, top);
+        std::copy(row.begin(), row.end(), bottom);
+    }
 }
 
 void PostProcessor::beginRender() {
-    glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+    bool effects = this->m_confuse || this->m_chaos || this->m_shake;
+    // the window's sample count is fixed at creation, any other count has to be rendered offscreen
+    bool windowSamples = this->m_settings.m_samples == 0 || this->m_settings.m_samples == this->m_windowSamples;
+    this->m_offscreen = effects || this->m_settings.m_fxaa || this->m_settings.m_renderScale < 1.0f || !windowSamples;
+    if (!this->m_offscreen) {
+        GLState::bindFramebuffer(GL_FRAMEBUFFER, this->m_outputFBO);
+    } else {
+        GLState::bindFramebuffer(GL_FRAMEBUFFER, this->m_settings.m_samples > 0 ? this->MSFBO : this->FBO);
+        glViewport(0, 0, this->m_sceneWidth, this->m_sceneHeight);
+    }
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void PostProcessor::endRender() {
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
-    glBlitFramebuffer(0, 0, this->m_width, this->m_height, 0, 0, this->m_width, this->m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    TraceScope trace("PostProcessor::endRender");
+    if (!this->m_offscreen) {
+        return;
+    }
+    if (this->m_settings.m_samples > 0) {
+        GLState::bindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
+        GLState::bindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
+        glBlitFramebuffer(0, 0, this->m_sceneWidth, this->m_sceneHeight, 0, 0, this->m_sceneWidth, this->m_sceneHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    GLState::bindFramebuffer(GL_FRAMEBUFFER, this->m_outputFBO);
+    glViewport(0, 0, this->m_width, this->m_height);
+    // the shake permutation moves the quad off the edges, the strip it uncovers has to be black and not an older frame
+    glClear(GL_COLOR_BUFFER_BIT);
 }
 
-void PostProcessor::render(float time) {
-    this->m_postProcessingShader.use();
-    this->m_postProcessingShader.setFloat("time", time);
-    this->m_postProcessingShader.setInteger("confuse", this->m_confuse);
-    this->m_postProcessingShader.setInteger("chaos", this->m_chaos);
-    this->m_postProcessingShader.setInteger("shake", this->m_shake);
+void PostProcessor::render() {
+    if (!this->m_offscreen) {
+        return;
+    }
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    unsigned int effects = 0;
+    if (this->m_chaos) {
+        effects |= POST_CHAOS;
+    } else if (this->m_confuse) {
+        effects |= POST_CONFUSE;
+    }
+    if (this->m_shake) {
+        effects |= POST_SHAKE;
+    }
+    if (this->m_settings.m_fxaa) {
+        effects |= POST_FXAA;
+    }
+    this->permutation(effects).use();
 
-    glActiveTexture(GL_TEXTURE0);
+    GLState::activeTexture(GL_TEXTURE0);
     this->m_texture.bind();
-    glBindVertexArray(this->VAO);
+    GLState::bindVertexArray(this->VAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    GLState::countDraw();
 }
 
 void PostProcessor::initRenderData() {
@@ -95,12 +225,12 @@ void PostProcessor::initRenderData() {
     glGenVertexArrays(1, &this->VAO);
     glGenBuffers(1, &VBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::bindArrayBuffer(VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->VAO);
+    GLState::bindVertexArray(this->VAO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::bindArrayBuffer(0);
+    GLState::bindVertexArray(0);
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef POST_PROCESSOR_H
 #define POST_PROCESSOR_H
 
+#include <map>
+#include <vector>
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
@@ -8,24 +11,61 @@
 #include "sprite_renderer.h"
 #include "shader.h"
 
+const float MIN_RENDER_SCALE = 0.25f;
+
+// bits of a post-processing shader permutation, each one becomes a #define in the compiled program
+enum PostEffect {
+    POST_CHAOS = 1,
+    POST_CONFUSE = 2,
+    POST_SHAKE = 4,
+    POST_FXAA = 8,
+    POST_PERMUTATIONS = 16
+};
+
+// anti-aliasing and resolution of the scene render, all of it can be changed while the game runs
+struct RenderSettings {
+    unsigned int m_samples;  // MSAA samples, 0 disables multisampling
+    bool m_fxaa;             // smooth edges in the final pass instead of (or on top of) MSAA
+    float m_renderScale;     // scene resolution relative to the window, upscaled by the final pass
+    bool m_outputTexture;    // final image goes into a texture instead of the default framebuffer, fixed at construction
+};
+
 class PostProcessor {
 public:
-    Shader m_postProcessingShader;
     Texture2D m_texture;
+    // holds the final image when RenderSettings::m_outputTexture is set, e.g. for contexts without a window
+    Texture2D m_output;
     unsigned int m_width, m_height;
 
     bool m_confuse, m_chaos, m_shake;
 
-    PostProcessor(Shader shader, unsigned int width, unsigned int height);
+    PostProcessor(unsigned int width, unsigned int height, RenderSettings settings);
+    // while no effect, FXAA or render scale is in use and the sample count matches the window, the scene goes straight
+    // to the output framebuffer and endRender()/render() do nothing. otherwise it is drawn into the offscreen target
     void beginRender();
     void endRender();
-    void render(float time);
+    void render();
+
+    // resizes or re-creates the offscreen targets when the samples or scale change
+    void setSettings(RenderSettings settings);
+    // reads the finished frame back as top-down RGBA rows, call after everything for the frame has been drawn
+    void readOutput(std::vector<unsigned char>& pixels);
+    RenderSettings settings() const { return this->m_settings; }
 private:
+    RenderSettings m_settings;
+    unsigned int m_windowSamples;
+    unsigned int m_sceneWidth, m_sceneHeight;
+    bool m_offscreen;
     unsigned int MSFBO, FBO;
+    unsigned int m_outputFBO;
     unsigned int RBO;
     unsigned int VAO;
+    // one program per effect combination, all compiled up front so switching effects never compiles mid-game
+    std::map<unsigned int, Shader> m_permutations;
 
     void initRenderData();
+    void initTargets();
+    Shader& permutation(unsigned int effects);
 };
 
 #endif
\ No newline at end of file
@@ -3,7 +3,6 @@
 
 #include <string>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "game_object.h"
@@ -17,8 +16,8 @@ public:
     float m_duration;
     bool m_activated;
 
-    PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Texture2D texture)
-        : GameObject(position, POWERUP_SIZE, texture, color, VELOCITY), m_type(type), m_duration(duration), m_activated()
+    PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Sprite sprite)
+        : GameObject(position, POWERUP_SIZE, sprite, color, VELOCITY), m_type(type), m_duration(duration), m_activated()
     {} 
 };
 
@@ -0,0 +1,138 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+const char* PHASE_NAMES[PHASE_COUNT] = {
+    "frame", "input", "update", "collisions", "particles", "powerups", "render", "swap"
+};
+
+// only the owning thread writes. m_sequence is odd while a record is in progress, so a summary running on another
+// thread copies a phase and retries until the sequence was even and unchanged around the copy (a seqlock). the
+// samples are relaxed atomics so the copy is no data race even when it has to be thrown away
+struct ProfileBuffer {
+    std::atomic<unsigned long long> m_samples[PHASE_COUNT][PROFILER_WINDOW];
+    std::atomic<unsigned int> m_written[PHASE_COUNT];
+    std::atomic<unsigned int> m_sequence;
+};
+
+// buffers live until exit so summaries can still read the samples of threads that have finished
+std::mutex bufferMutex;
+std::vector<ProfileBuffer*> buffers;
+
+ProfileBuffer* threadBuffer() {
+    static thread_local ProfileBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        buffer = new ProfileBuffer();
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        buffers.push_back(buffer);
+    }
+    return buffer;
+}
+
+void Profiler::record(ProfilePhase phase, unsigned long long nanoseconds) {
+    ProfileBuffer* buffer = threadBuffer();
+    unsigned int sequence = buffer->m_sequence.load(std::memory_order_relaxed);
+    buffer->m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    unsigned int written = buffer->m_written[phase].load(std::memory_order_relaxed);
+    buffer->m_samples[phase][written % PROFILER_WINDOW].store(nanoseconds, std::memory_order_relaxed);
+    buffer->m_written[phase].store(written + 1, std::memory_order_relaxed);
+    buffer->m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// consistent copy of one phase of a buffer another thread may be recording into
+void snapshot(const ProfileBuffer& buffer, ProfilePhase phase, std::vector<unsigned long long>& samples) {
+    size_t start = samples.size();
+    while (true) {
+        unsigned int before = buffer.m_sequence.load(std::memory_order_acquire);
+        if (before % 2 == 0) {
+            unsigned int count = std::min(buffer.m_written[phase].load(std::memory_order_relaxed), PROFILER_WINDOW);
+            for (unsigned int i = 0; i < count; ++i) {
+                samples.push_back(buffer.m_samples[phase][i].load(std::memory_order_relaxed));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer.m_sequence.load(std::memory_order_relaxed) == before) {
+                return;
+            }
+            samples.resize(start);
+        }
+    }
+}
+
+// nearest-rank percentile of sorted samples
+double percentile(const std::vector<unsigned long long>& sorted, double p) {
+    size_t rank = (size_t)(p * sorted.size() + 0.999999);
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1] / 1e6;
+}
+
+PhaseSummary Profiler::summarize(ProfilePhase phase) {
+    std::vector<unsigned long long> samples;
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        for (ProfileBuffer* buffer : buffers) {
+            snapshot(*buffer, phase, samples);
+        }
+    }
+
+    PhaseSummary summary = { (unsigned int)samples.size(), 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if (samples.empty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    unsigned long long total = 0;
+    for (unsigned long long sample : samples) {
+        total += sample;
+    }
+    summary.m_mean = total / 1e6 / samples.size();
+    summary.m_p50 = percentile(samples, 0.50);
+    summary.m_p95 = percentile(samples, 0.95);
+    summary.m_p99 = percentile(samples, 0.99);
+    summary.m_max = samples.back() / 1e6;
+    return summary;
+}
+
+const char* Profiler::phaseName(ProfilePhase phase) {
+    return PHASE_NAMES[phase];
+}
+
+bool Profiler::dump(const std::string& base) {
+    bool written = writeCsv(base + ".csv") && writeJson(base + ".json");
+    if (!written) {
+        std::cout << "ERROR::PROFILER: Failed to write " << base << ".csv/.json" << std::endl;
+    }
+    return written;
+}
+
+unsigned long long Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool Profiler::writeCsv(const std::string& file) {
+    std::ofstream stream(file);
+    stream << "phase,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (unsigned int phase = 0; phase < PHASE_COUNT; ++phase) {
+        PhaseSummary summary = summarize((ProfilePhase)phase);
+        stream << PHASE_NAMES[phase] << ',' << summary.m_samples << ',' << summary.m_mean << ',' << summary.m_p50 << ','
+            << summary.m_p95 << ',' << summary.m_p99 << ',' << summary.m_max << '\n';
+    }
+    return stream.good();
+}
+
+bool Profiler::writeJson(const std::string& file) {
+    std::ofstream stream(file);
+    stream << "{\n  \"window\": " << PROFILER_WINDOW << ",\n  \"phases\": {";
+    for (unsigned int phase = 0; phase < PHASE_COUNT; ++phase) {
+        PhaseSummary summary = summarize((ProfilePhase)phase);
+        stream << (phase > 0 ? ",\n" : "\n") << "    \"" << PHASE_NAMES[phase] << "\": { \"samples\": " << summary.m_samples
+            << ", \"mean_ms\": " << summary.m_mean << ", \"p50_ms\": " << summary.m_p50 << ", \"p95_ms\": " << summary.m_p95
+            << ", \"p99_ms\": " << summary.m_p99 << ", \"max_ms\": " << summary.m_max << " }";
+    }
+    stream << "\n  }\n}\n";
+    return stream.good();
+}
\ No newline at end of file
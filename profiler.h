@@ -0,0 +1,57 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+
+// CPU phases of a frame, the nested ones are sub-steps of Game::update
+enum ProfilePhase {
+    PHASE_FRAME,
+    PHASE_INPUT,
+    PHASE_UPDATE,
+    PHASE_COLLISIONS,
+    PHASE_PARTICLES,
+    PHASE_POWERUPS,
+    PHASE_RENDER,
+    PHASE_SWAP,
+    PHASE_COUNT
+};
+
+// every phase keeps its last PROFILER_WINDOW samples per thread
+const unsigned int PROFILER_WINDOW = 1024;
+
+// milliseconds over the samples currently in the window
+struct PhaseSummary {
+    unsigned int m_samples;
+    double m_mean, m_p50, m_p95, m_p99, m_max;
+};
+
+// samples go into a thread_local ring buffer per thread so recording never takes a lock, only the first sample of
+// a thread registers its buffer. summaries take a consistent copy of every thread's buffer, also of threads that are
+// still recording
+class Profiler {
+public:
+    static void record(ProfilePhase phase, unsigned long long nanoseconds);
+    static PhaseSummary summarize(ProfilePhase phase);
+    static const char* phaseName(ProfilePhase phase);
+
+    // writes <base>.csv and <base>.json with a row/object per phase
+    static bool dump(const std::string& base);
+    static unsigned long long now();
+private:
+    Profiler() {}
+
+    static bool writeCsv(const std::string& file);
+    static bool writeJson(const std::string& file);
+};
+
+// times its own lifetime into a phase
+class ProfileScope {
+public:
+    ProfileScope(ProfilePhase phase) : m_phase(phase), m_start(Profiler::now()) {}
+    ~ProfileScope() { Profiler::record(this->m_phase, Profiler::now() - this->m_start); }
+private:
+    ProfilePhase m_phase;
+    unsigned long long m_start;
+};
+
+#endif
\ No newline at end of file
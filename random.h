@@ -0,0 +1,29 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// xorshift32 generator. the simulation draws from its own seeded instance instead of rand(), so a run depends only
+// on the seed and the inputs, not on the C library or on whatever else called rand() in between
+class Random {
+public:
+    Random(uint32_t seed = 1) { this->seed(seed); }
+
+    // xorshift never leaves the zero state, so a zero seed is replaced
+    void seed(uint32_t seed) { this->m_state = seed != 0 ? seed : 0x9e3779b9u; }
+
+    uint32_t next() {
+        uint32_t x = this->m_state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return this->m_state = x;
+    }
+
+    // uniform enough for gameplay in [0, range), range must not be zero
+    unsigned int below(unsigned int range) { return this->next() % range; }
+private:
+    uint32_t m_state;
+};
+
+#endif
\ No newline at end of file
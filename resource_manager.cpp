@@ -1,5 +1,10 @@
 #include "resource_manager.h"
+#include "gl_state.h"
+#include "frame_uniforms.h"
+#include "trace.h"
 
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -7,12 +12,24 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+// linked program binaries, keyed by a hash of the shader sources and the driver strings
+const char* PROGRAM_CACHE_DIR = "shader_cache";
+
 // instantiate static variables
 std::map<std::string, Texture2D> ResourceManager::m_textures;
 std::map<std::string, Shader> ResourceManager::m_shaders;
 
-Shader ResourceManager::loadShader(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile, std::string name) {
-    m_shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
+Shader ResourceManager::loadShader(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile, std::string name,
+    const std::string& defines)
+{
+    TraceScope trace("ResourceManager::loadShader");
+    m_shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile, std::vector<std::string>(), defines);
+    return m_shaders[name];
+}
+
+Shader ResourceManager::loadFeedbackShader(const char* vShaderFile, const std::vector<std::string>& varyings, std::string name) {
+    TraceScope trace("ResourceManager::loadFeedbackShader");
+    m_shaders[name] = loadShaderFromFile(vShaderFile, nullptr, nullptr, varyings);
     return m_shaders[name];
 }
 
@@ -21,6 +38,7 @@ Shader& ResourceManager::getShader(std::string name) {
 }
 
 Texture2D ResourceManager::loadTexture(const char* file, bool alpha, std::string name) {
+    TraceScope trace("ResourceManager::loadTexture");
     m_textures[name] = loadTextureFromFile(file, alpha);
     return m_textures[name];
 }
@@ -36,25 +54,29 @@ void ResourceManager::clear() {
     for (auto iter : m_textures) {
         glDeleteTextures(1, &iter.second.ID);
     }
+    GLState::invalidate();
 }
 
-Shader ResourceManager::loadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile) {
+Shader ResourceManager::loadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile,
+    const std::vector<std::string>& feedbackVaryings, const std::string& defines)
+{
     std::string vertexCode;
     std::string fragmentCode;
     std::string geometryCode;
     try {
         std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-
+        std::stringstream vShaderStream;
         vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-
         vertexShaderFile.close();
-        fragmentShaderFile.close();
-
         vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+
+        if (fShaderFile != nullptr) {
+            std::ifstream fragmentShaderFile(fShaderFile);
+            std::stringstream fShaderStream;
+            fShaderStream << fragmentShaderFile.rdbuf();
+            fragmentShaderFile.close();
+            fragmentCode = fShaderStream.str();
+        }
 
         if (gShaderFile != nullptr) {
             std::ifstream geometryShaderFile(gShaderFile);
@@ -66,15 +88,97 @@ Shader ResourceManager::loadShaderFromFile(const char* vShaderFile, const char*
     } catch (std::exception& e) {
         std::cout << "ERROR::SHADER: Failed to read shader files." << std::endl;
     } 
+    if (!defines.empty()) {
+        injectDefines(vertexCode, defines);
+        injectDefines(fragmentCode, defines);
+        injectDefines(geometryCode, defines);
+    }
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
     const char* gShaderCode = geometryCode.c_str();
 
     Shader shader;
-    shader.compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
+    std::string cacheFile;
+    if (Shader::binarySupported()) {
+        cacheFile = programCacheFile(vertexCode, fShaderFile != nullptr ? fragmentCode : std::string(),
+            gShaderFile != nullptr ? geometryCode : std::string(), feedbackVaryings);
+    }
+    if (cacheFile.empty() || !loadCachedProgram(cacheFile, shader)) {
+        shader.compile(vShaderCode, fShaderFile != nullptr ? fShaderCode : nullptr, gShaderFile != nullptr ? gShaderCode : nullptr,
+            feedbackVaryings);
+        if (!cacheFile.empty()) {
+            saveCachedProgram(cacheFile, shader);
+        }
+    }
+
+    unsigned int frameBlock = glGetUniformBlockIndex(shader.ID, "Frame");
+    if (frameBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(shader.ID, frameBlock, FRAME_UNIFORM_BINDING);
+    }
     return shader;
 }
 
+std::string ResourceManager::programCacheFile(const std::string& vertexCode, const std::string& fragmentCode,
+    const std::string& geometryCode, const std::vector<std::string>& feedbackVaryings)
+{
+    // binaries are only valid for the driver that produced them, so its strings are part of the key
+    std::string key;
+    const GLubyte* driverStrings[] = { glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION) };
+    for (const GLubyte* driverString : driverStrings) {
+        key += driverString != nullptr ? reinterpret_cast<const char*>(driverString) : "";
+        key += '\0';
+    }
+    key += vertexCode + '\0' + fragmentCode + '\0' + geometryCode + '\0';
+    for (const std::string& varying : feedbackVaryings) {
+        key += varying + '\0';
+    }
+
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return std::string(PROGRAM_CACHE_DIR) + "/" + name;
+}
+
+bool ResourceManager::loadCachedProgram(const std::string& cacheFile, Shader& shader) {
+    std::ifstream file(cacheFile, std::ios::binary);
+    uint32_t format = 0;
+    if (!file.read(reinterpret_cast<char*>(&format), sizeof(format))) {
+        return false;
+    }
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return !binary.empty() && shader.loadBinary(format, binary);
+}
+
+void ResourceManager::saveCachedProgram(const std::string& cacheFile, const Shader& shader) {
+    unsigned int format = 0;
+    std::vector<char> binary;
+    if (!shader.getBinary(format, binary)) {
+        return;
+    }
+    FileSystem::makeDir(PROGRAM_CACHE_DIR);
+    std::ofstream file(cacheFile, std::ios::binary | std::ios::trunc);
+    uint32_t storedFormat = format;
+    file.write(reinterpret_cast<const char*>(&storedFormat), sizeof(storedFormat));
+    file.write(binary.data(), binary.size());
+    if (!file) {
+        std::cout << "ERROR::SHADER: Failed to write program cache " << cacheFile << std::endl;
+    }
+}
+
+void ResourceManager::injectDefines(std::string& code, const std::string& defines) {
+    // #version has to stay the first statement
+    size_t position = 0;
+    if (code.compare(0, 8, "#version") == 0) {
+        position = code.find('\n');
+        position = position == std::string::npos ? code.size() : position + 1;
+    }
+    code.insert(position, defines);
+}
+
 Texture2D ResourceManager::loadTextureFromFile(const char* file, bool alpha) {
     Texture2D texture;
     if (alpha) {
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -14,15 +15,25 @@ public:
     static std::map<std::string, Shader> m_shaders;
     static std::map<std::string, Texture2D> m_textures;
 
-    static Shader loadShader(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile, std::string name);
+    // defines are inserted right after the #version line of every stage, e.g. "#define FXAA\n"
+    static Shader loadShader(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile, std::string name,
+        const std::string& defines = std::string());
+    static Shader loadFeedbackShader(const char* vShaderFile, const std::vector<std::string>& varyings, std::string name);
     static Shader& getShader(std::string name);
     static Texture2D loadTexture(const char* file, bool alpha, std::string name);
     static Texture2D& getTexture(std::string name);
     static void clear();
 private:    
     ResourceManager() {}
-    static Shader loadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile = nullptr);
+    static Shader loadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile = nullptr,
+        const std::vector<std::string>& feedbackVaryings = std::vector<std::string>(), const std::string& defines = std::string());
+    static void injectDefines(std::string& code, const std::string& defines);
     static Texture2D loadTextureFromFile(const char* file, bool alpha);
+
+    static std::string programCacheFile(const std::string& vertexCode, const std::string& fragmentCode,
+        const std::string& geometryCode, const std::vector<std::string>& feedbackVaryings);
+    static bool loadCachedProgram(const std::string& cacheFile, Shader& shader);
+    static void saveCachedProgram(const std::string& cacheFile, const Shader& shader);
 };
 
 #endif
\ No newline at end of file
@@ -1,24 +1,29 @@
 #include "shader.h"
+#include "gl_state.h"
 
 #include <iostream>
 
 Shader& Shader::use() {
-    glUseProgram(this->ID);
+    GLState::useProgram(this->ID);
     return *this;
 }
 
-void Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
-    unsigned int sVertex, sFragment, gShader;
+void Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource,
+    const std::vector<std::string>& feedbackVaryings)
+{
+    unsigned int sVertex = 0, sFragment = 0, gShader = 0;
 
     sVertex = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(sVertex, 1, &vertexSource, NULL);
     glCompileShader(sVertex);
     checkCompileErrors(sVertex, "VERTEX");
 
-    sFragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(sFragment, 1, &fragmentSource, NULL);
-    glCompileShader(sFragment);
-    checkCompileErrors(sFragment, "FRAGMENT");
+    if (fragmentSource != nullptr) {
+        sFragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(sFragment, 1, &fragmentSource, NULL);
+        glCompileShader(sFragment);
+        checkCompileErrors(sFragment, "FRAGMENT");
+    }
 
     if (geometrySource != nullptr) {
         gShader = glCreateShader(GL_GEOMETRY_SHADER);
@@ -29,81 +34,180 @@ void Shader::compile(const char* vertexSource, const char* fragmentSource, const
 
     this->ID = glCreateProgram();
     glAttachShader(this->ID, sVertex);
-    glAttachShader(this->ID, sFragment);
+    if (fragmentSource != nullptr) {
+        glAttachShader(this->ID, sFragment);
+    }
     if (geometrySource != nullptr) {
         glAttachShader(this->ID, gShader);
     }
+    if (!feedbackVaryings.empty()) {
+        std::vector<const char*> varyings;
+        for (const std::string& varying : feedbackVaryings) {
+            varyings.push_back(varying.c_str());
+        }
+        glTransformFeedbackVaryings(this->ID, varyings.size(), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+    }
+    if (binarySupported()) {
+        glProgramParameteri(this->ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(this->ID);
     checkCompileErrors(this->ID, "PROGRAM");
+    this->queryUniforms();
 
     glDeleteShader(sVertex);
-    glDeleteShader(sFragment);
+    if (fragmentSource != nullptr) {
+        glDeleteShader(sFragment);
+    }
     if (geometrySource != nullptr) {
         glDeleteShader(gShader);
     }
 }
 
 void Shader::setFloat(const char* name, float value, bool useShader) {
-    if (useShader) {
-        this->use();
-    }
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    this->setFloat(this->getUniformLocation(name), value, useShader);
 }
 
 void Shader::setInteger(const char* name, int value, bool useShader) {
-    if (useShader) {
-        this->use();
-    }
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
+    this->setInteger(this->getUniformLocation(name), value, useShader);
 }
 
 void Shader::setVector2f(const char* name, float x, float y, bool useShader) {
-    if (useShader) { 
-        this->use();
-    }
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    this->setVector2f(this->getUniformLocation(name), glm::vec2(x, y), useShader);
 }
 
 void Shader::setVector2f(const char* name, const glm::vec2& value, bool useShader) {
+    this->setVector2f(this->getUniformLocation(name), value, useShader);
+}
+
+void Shader::setVector3f(const char* name, float x, float y, float z, bool useShader) {
+    this->setVector3f(this->getUniformLocation(name), glm::vec3(x, y, z), useShader);
+}
+
+void Shader::setVector3f(const char* name, const glm::vec3& value, bool useShader) {
+    this->setVector3f(this->getUniformLocation(name), value, useShader);
+}
+
+void Shader::setVector4f(const char* name, float x, float y, float z, float w, bool useShader) {
+    this->setVector4f(this->getUniformLocation(name), glm::vec4(x, y, z, w), useShader);
+}
+
+void Shader::setVector4f(const char* name, const glm::vec4& value, bool useShader) {
+    this->setVector4f(this->getUniformLocation(name), value, useShader);
+}
+
+void Shader::setMatrix4(const char* name, const glm::mat4& matrix, bool useShader) {
+    this->setMatrix4(this->getUniformLocation(name), matrix, useShader);
+}
+
+void Shader::setFloat(int location, float value, bool useShader) {
     if (useShader) {
         this->use();
     }
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    glUniform1f(location, value);
 }
 
-void Shader::setVector3f(const char* name, float x, float y, float z, bool useShader) {
+void Shader::setInteger(int location, int value, bool useShader) {
     if (useShader) {
         this->use();
     }
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    glUniform1i(location, value);
 }
 
-void Shader::setVector3f(const char* name, const glm::vec3& value, bool useShader) {
+void Shader::setVector2f(int location, const glm::vec2& value, bool useShader) {
     if (useShader) {
         this->use();
     }
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    glUniform2f(location, value.x, value.y);
 }
 
-void Shader::setVector4f(const char* name, float x, float y, float z, float w, bool useShader) {
+void Shader::setVector3f(int location, const glm::vec3& value, bool useShader) {
     if (useShader) {
         this->use();
     }
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    glUniform3f(location, value.x, value.y, value.z);
 }
 
-void Shader::setVector4f(const char* name, const glm::vec4& value, bool useShader) {
+void Shader::setVector4f(int location, const glm::vec4& value, bool useShader) {
     if (useShader) {
         this->use();
     }
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    glUniform4f(location, value.x, value.y, value.z, value.w);
 }
 
-void Shader::setMatrix4(const char* name, const glm::mat4& matrix, bool useShader) {
+void Shader::setMatrix4(int location, const glm::mat4& matrix, bool useShader) {
     if (useShader) {
         this->use();
     }
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+    glUniformMatrix4fv(location, 1, false, glm::value_ptr(matrix));
+}
+
+bool Shader::binarySupported() {
+    // glProgramBinary is core in 4.1, on 3.3 contexts it depends on ARB_get_program_binary
+    if (glProgramBinary == nullptr || glGetProgramBinary == nullptr || glProgramParameteri == nullptr) {
+        return false;
+    }
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+bool Shader::getBinary(unsigned int& format, std::vector<char>& binary) const {
+    int length = 0;
+    glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return false;
+    }
+    binary.resize(length);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(this->ID, length, &length, &binaryFormat, binary.data());
+    binary.resize(length);
+    format = binaryFormat;
+    return length > 0;
+}
+
+bool Shader::loadBinary(unsigned int format, const std::vector<char>& binary) {
+    this->ID = glCreateProgram();
+    glProgramBinary(this->ID, format, binary.data(), binary.size());
+    int success = 0;
+    glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(this->ID);
+        this->ID = 0;
+        return false;
+    }
+    this->queryUniforms();
+    return true;
+}
+
+int Shader::getUniformLocation(const char* name) const {
+    auto iter = this->m_uniforms.find(name);
+    return iter != this->m_uniforms.end() ? iter->second : -1;
+}
+
+void Shader::queryUniforms() {
+    this->m_uniforms.clear();
+
+    int count = 0, maxLength = 0;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> buffer(maxLength + 1);
+    for (int i = 0; i < count; ++i) {
+        int length = 0, size = 0;
+        unsigned int type;
+        glGetActiveUniform(this->ID, i, buffer.size(), &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), length);
+
+        int location = glGetUniformLocation(this->ID, name.c_str());
+        if (location < 0) { // members of uniform blocks have no location
+            continue;
+        }
+        this->m_uniforms[name] = location;
+
+        // arrays are reported as "name[0]", make them reachable by their plain name too
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            this->m_uniforms[name.substr(0, name.size() - 3)] = location;
+        }
+    }
 }
 
 void Shader::checkCompileErrors(unsigned int object, std::string type) {
@@ -1,7 +1,9 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -9,6 +11,8 @@
 
 #include "file_system.h"
 
+// uniform locations are queried once after linking, the name based setters look them up in that cache
+// and the location based ones let callers skip the lookup entirely
 class Shader {
 public:
     unsigned int ID;
@@ -17,7 +21,17 @@ public:
 
     Shader& use();
 
-    void compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource = nullptr);
+    // fragmentSource may be null for programs that only capture vertex outputs through transform feedback
+    void compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource = nullptr,
+        const std::vector<std::string>& feedbackVaryings = std::vector<std::string>());
+
+    // linked programs can be saved with getBinary() and restored with loadBinary(), which fails when the driver
+    // no longer accepts the binary (e.g. after a driver update). only usable when binarySupported() is true
+    static bool binarySupported();
+    bool getBinary(unsigned int& format, std::vector<char>& binary) const;
+    bool loadBinary(unsigned int format, const std::vector<char>& binary);
+
+    int getUniformLocation(const char* name) const;
 
     void setFloat(const char* name, float value, bool useShader = false);
     void setInteger(const char* name, int value, bool useShader = false);
@@ -28,8 +42,18 @@ public:
     void setVector4f(const char* name, float x, float y, float z, float w, bool useShader = false);
     void setVector4f(const char* name, const glm::vec4& value, bool useShader = false);
     void setMatrix4(const char* name, const glm::mat4& matrix, bool useShader = false);
+
+    void setFloat(int location, float value, bool useShader = false);
+    void setInteger(int location, int value, bool useShader = false);
+    void setVector2f(int location, const glm::vec2& value, bool useShader = false);
+    void setVector3f(int location, const glm::vec3& value, bool useShader = false);
+    void setVector4f(int location, const glm::vec4& value, bool useShader = false);
+    void setMatrix4(int location, const glm::mat4& matrix, bool useShader = false);
 private:
+    std::map<std::string, int, std::less<>> m_uniforms;
+
     void checkCompileErrors(unsigned int object, std::string type);
+    void queryUniforms();
 };
 
 #endif
\ No newline at end of file
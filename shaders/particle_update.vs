@@ -0,0 +1,24 @@
+#version 330 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 velocity;
+layout (location = 2) in vec4 color;
+layout (location = 3) in float life;
+
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec4 outColor;
+out float outLife;
+
+uniform float dt;
+uniform float fadeRate;
+
+void main() {
+    outPosition = position;
+    outVelocity = velocity;
+    outColor = color;
+    outLife = life - dt;
+    if (outLife > 0.0) {
+        outPosition -= velocity * dt;
+        outColor.a -= dt * fadeRate;
+    }
+}
\ No newline at end of file
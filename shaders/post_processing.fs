@@ -7,33 +7,68 @@ uniform vec2 offsets[9];
 uniform int edge_kernel[9];
 uniform float blur_kernel[9];
 
-uniform bool chaos;
-uniform bool confuse;
-uniform bool shake;
+#ifdef FXAA
+uniform vec2 texelSize;
+
+const float FXAA_SPAN_MAX = 8.0;
+const float FXAA_REDUCE_MUL = 1.0 / 8.0;
+const float FXAA_REDUCE_MIN = 1.0 / 128.0;
+
+// blurs along the edge direction estimated from the luma of the four diagonal neighbours
+vec3 antialias(vec2 uv) {
+    const vec3 toLuma = vec3(0.299, 0.587, 0.114);
+    float lumaNW = dot(texture(scene, uv + vec2(-1.0, -1.0) * texelSize).rgb, toLuma);
+    float lumaNE = dot(texture(scene, uv + vec2( 1.0, -1.0) * texelSize).rgb, toLuma);
+    float lumaSW = dot(texture(scene, uv + vec2(-1.0,  1.0) * texelSize).rgb, toLuma);
+    float lumaSE = dot(texture(scene, uv + vec2( 1.0,  1.0) * texelSize).rgb, toLuma);
+    float lumaM = dot(texture(scene, uv).rgb, toLuma);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * FXAA_REDUCE_MUL, FXAA_REDUCE_MIN);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * texelSize;
+
+    vec3 rgbA = 0.5 * (texture(scene, uv + dir * (1.0 / 3.0 - 0.5)).rgb + texture(scene, uv + dir * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (texture(scene, uv - dir * 0.5).rgb + texture(scene, uv + dir * 0.5).rgb);
+    float lumaB = dot(rgbB, toLuma);
+    return (lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB;
+}
+#endif
+
+// CHAOS, CONFUSE, SHAKE and FXAA are defined per permutation by PostProcessor
+vec3 sceneColor(vec2 uv) {
+#ifdef FXAA
+    return antialias(uv);
+#else
+    return texture(scene, uv).rgb;
+#endif
+}
 
 void main() {
-    color = vec4(0.0f);
+#if defined(CHAOS) || defined(SHAKE)
     vec3 sample[9];
-
-    if (chaos || shake) {
-        for (int i = 0; i < 9; ++i) {
-            sample[i] = vec3(texture(scene, TexCoords.st + offsets[i]));
-        }
+    for (int i = 0; i < 9; ++i) {
+        sample[i] = vec3(texture(scene, TexCoords.st + offsets[i]));
     }
+#endif
 
-    if (chaos) {
-        for (int i = 0; i < 9; ++i) {
-            color += vec4(sample[i] * edge_kernel[i], 0.0f);
-        }
-        color.a = 1.0f;
-    } else if (confuse) {
-        color = vec4(1.0 - texture(scene, TexCoords).rgb, 1.0);
-    } else if (shake) {
-        for (int i = 0; i < 9; ++i) {
-            color += vec4(sample[i] * blur_kernel[i], 0.0f);
-        }
-        color.a = 1.0f;
-    } else {
-        color = texture(scene, TexCoords);
+#if defined(CHAOS)
+    color = vec4(0.0f);
+    for (int i = 0; i < 9; ++i) {
+        color += vec4(sample[i] * edge_kernel[i], 0.0f);
+    }
+    color.a = 1.0f;
+#elif defined(CONFUSE)
+    color = vec4(1.0 - sceneColor(TexCoords), 1.0);
+#elif defined(SHAKE)
+    color = vec4(0.0f);
+    for (int i = 0; i < 9; ++i) {
+        color += vec4(sample[i] * blur_kernel[i], 0.0f);
     }
+    color.a = 1.0f;
+#else
+    color = vec4(sceneColor(TexCoords), 1.0);
+#endif
 }
\ No newline at end of file
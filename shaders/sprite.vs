@@ -1,12 +1,23 @@
 #version 330 core
 layout (location = 0) in vec4 vertex;
+layout (location = 1) in vec4 instanceRect;
+layout (location = 2) in vec4 instanceColor;
 
 out vec2 TexCoords;
+out vec3 SpriteColor;
 
-uniform mat4 model;
-uniform mat4 projection;
+layout (std140) uniform Frame {
+    mat4 projection;
+    float time;
+};
 
 void main() {
+    vec2 size = instanceRect.zw;
+    float angle = radians(instanceColor.w);
+    mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+    vec2 position = instanceRect.xy + 0.5 * size + rotation * ((vertex.xy - 0.5) * size);
+
     TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+    SpriteColor = instanceColor.rgb;
+    gl_Position = projection * vec4(position, 0.0, 1.0);
 }
\ No newline at end of file
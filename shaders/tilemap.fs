@@ -0,0 +1,24 @@
+#version 330 core
+in vec2 LevelPos;
+out vec4 color;
+
+uniform usampler2D tiles;
+uniform sampler2D block;
+uniform sampler2D solidBlock;
+uniform vec2 unitSize;
+uniform vec3 palette[6];
+
+void main() {
+    vec2 cell = LevelPos / unitSize;
+    uint code = texelFetch(tiles, min(ivec2(cell), textureSize(tiles, 0) - 1), 0).r;
+
+    // both textures are sampled before the branch so the implicit derivatives stay defined
+    vec2 uv = fract(cell);
+    vec4 blockColor = texture(block, uv);
+    vec4 solidColor = texture(solidBlock, uv);
+    if (code == 0u) {
+        discard;
+    }
+    vec3 tint = code < 6u ? palette[code] : vec3(1.0);
+    color = vec4(tint, 1.0) * (code == 1u ? solidColor : blockColor);
+}
\ No newline at end of file
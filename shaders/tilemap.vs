@@ -0,0 +1,16 @@
+#version 330 core
+out vec2 LevelPos;
+
+layout (std140) uniform Frame {
+    mat4 projection;
+    float time;
+};
+uniform vec2 levelSize;
+
+void main() {
+    // same corner order as the sprite quad, generated from the vertex id so no vertex buffer is needed
+    vec2 corner = vec2(gl_VertexID == 1 || gl_VertexID == 4 || gl_VertexID == 5 ? 1.0 : 0.0,
+                       gl_VertexID == 0 || gl_VertexID == 3 || gl_VertexID == 4 ? 1.0 : 0.0);
+    LevelPos = corner * levelSize;
+    gl_Position = projection * vec4(LevelPos, 0.0, 1.0);
+}
\ No newline at end of file
@@ -1,39 +1,121 @@
 #include "sprite_renderer.h"
+#include "gl_state.h"
 
-SpriteRenderer::SpriteRenderer(Shader& shader) {
+#include <algorithm>
+#include <cstddef>
+
+SpriteRenderer::SpriteRenderer(Shader& shader)
+    : m_instanceCapacity(0), m_batching(false), m_batchCount(0)
+{
     this->m_shader = shader;
     this->initRenderData();
 }
 
 SpriteRenderer::~SpriteRenderer() {
     glDeleteVertexArrays(1, &this->m_quadVAO);
+    glDeleteBuffers(1, &this->m_quadVBO);
+    glDeleteBuffers(1, &this->m_instanceVBO);
+    GLState::invalidate();
+}
+
+void SpriteRenderer::begin() {
+    this->m_batching = true;
+}
+
+void SpriteRenderer::end() {
+    this->m_batching = false;
+    this->flush();
 }
 
 void SpriteRenderer::drawSprite(Texture2D& texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color) {
-    this->m_shader.use();
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(position, 0.0f));
+    unsigned int slot = 0;
+    while (slot < this->m_batchCount && this->m_batches[slot].m_texture != texture.ID) {
+        ++slot;
+    }
+    if (slot == this->m_batchCount) {
+        if (slot == this->m_batches.size()) {
+            this->m_batches.push_back(SpriteBatch());
+        }
+        this->m_batches[slot].m_texture = texture.ID;
+        ++this->m_batchCount;
+    }
 
-    model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f));
-    model = glm::rotate(model, glm::radians(rotate), glm::vec3(0.0f, 0.0f, 1.0f));
-    model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f));
+    SpriteInstance instance;
+    instance.m_position = position;
+    instance.m_size = size;
+    instance.m_color = color;
+    instance.m_rotation = rotate;
+    this->m_batches[slot].m_instances.push_back(instance);
 
-    model = glm::scale(model, glm::vec3(size, 1.0f));
+    if (!this->m_batching) {
+        this->flush();
+    }
+}
 
-    this->m_shader.setMatrix4("model", model);
+unsigned int SpriteRenderer::createInstanceArray(unsigned int instanceVBO, unsigned int first) {
+    unsigned int VAO;
+    glGenVertexArrays(1, &VAO);
+    this->initVertexArray(VAO, instanceVBO, first);
+    return VAO;
+}
 
-    this->m_shader.setVector3f("spriteColor", color);
+void SpriteRenderer::drawInstances(unsigned int VAO, const Texture2D& texture, unsigned int count) {
+    this->flush();
 
-    glActiveTexture(GL_TEXTURE0);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    this->m_shader.use();
+    GLState::activeTexture(GL_TEXTURE0);
     texture.bind();
+    GLState::bindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+    GLState::countDraw();
+}
+
+void SpriteRenderer::flush() {
+    if (this->m_batchCount == 0) {
+        return;
+    }
 
-    glBindVertexArray(this->m_quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    this->m_staging.clear();
+    for (unsigned int i = 0; i < this->m_batchCount; ++i) {
+        const std::vector<SpriteInstance>& instances = this->m_batches[i].m_instances;
+        this->m_staging.insert(this->m_staging.end(), instances.begin(), instances.end());
+    }
+
+    GLState::bindArrayBuffer(this->m_instanceVBO);
+    if (this->m_staging.size() > this->m_instanceCapacity) {
+        this->m_instanceCapacity = std::max<unsigned int>(this->m_staging.size(), this->m_instanceCapacity * 2);
+    }
+    // orphan the previous contents so the driver does not stall on draws still reading them
+    glBufferData(GL_ARRAY_BUFFER, this->m_instanceCapacity * sizeof(SpriteInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, this->m_staging.size() * sizeof(SpriteInstance), this->m_staging.data());
+
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    this->m_shader.use();
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindVertexArray(this->m_quadVAO);
+
+    unsigned int first = 0;
+    for (unsigned int i = 0; i < this->m_batchCount; ++i) {
+        SpriteBatch& batch = this->m_batches[i];
+        GLState::bindTexture(batch.m_texture);
+        this->setInstanceOffset(first);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, batch.m_instances.size());
+        GLState::countDraw();
+
+        first += batch.m_instances.size();
+        batch.m_instances.clear();
+    }
+    this->m_batchCount = 0;
+}
+
+void SpriteRenderer::setInstanceOffset(unsigned int first) {
+    size_t offset = first * sizeof(SpriteInstance);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, m_position)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, m_color)));
 }
 
 void SpriteRenderer::initRenderData() {
-    unsigned int VBO;
     float vertices[] = {
         // pos      // tex
         0.0f, 1.0f, 0.0f, 1.0f,
@@ -46,14 +128,29 @@ void SpriteRenderer::initRenderData() {
     };
 
     glGenVertexArrays(1, &this->m_quadVAO);
-    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &this->m_quadVBO);
+    glGenBuffers(1, &this->m_instanceVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::bindArrayBuffer(this->m_quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->m_quadVAO);
+    this->initVertexArray(this->m_quadVAO, this->m_instanceVBO, 0);
+}
+
+void SpriteRenderer::initVertexArray(unsigned int VAO, unsigned int instanceVBO, unsigned int first) {
+    GLState::bindVertexArray(VAO);
+    GLState::bindArrayBuffer(this->m_quadVBO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+
+    // per-instance attributes: (position, size) and (color, rotation)
+    GLState::bindArrayBuffer(instanceVBO);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    this->setInstanceOffset(first);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribDivisor(2, 1);
+
+    GLState::bindArrayBuffer(0);
+    GLState::bindVertexArray(0);
 }
\ No newline at end of file
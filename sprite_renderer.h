@@ -1,6 +1,8 @@
 #ifndef SPRITE_RENDERER_H
 #define SPRITE_RENDERER_H
 
+#include <vector>
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -8,16 +10,50 @@
 #include "texture.h"
 #include "shader.h"
 
+struct SpriteInstance {
+    glm::vec2 m_position;
+    glm::vec2 m_size;
+    glm::vec3 m_color;
+    float m_rotation;
+};
+
+struct SpriteBatch {
+    unsigned int m_texture;
+    std::vector<SpriteInstance> m_instances;
+};
+
 class SpriteRenderer {
 public:
     SpriteRenderer(Shader& shader);
     ~SpriteRenderer();
+
+    // sprites drawn between begin() and end() are collected and flushed with one instanced draw per texture,
+    // textures are flushed in order of first use so sprites sharing a texture must not depend on each other's draw order
+    void begin();
+    void end();
     void drawSprite(Texture2D& texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+
+    // vertex array that reads SpriteInstance data starting at instance `first` of a buffer owned by the caller
+    unsigned int createInstanceArray(unsigned int instanceVBO, unsigned int first);
+    // draws `count` instances from such a vertex array, sprites queued before it are flushed first to keep the draw order
+    void drawInstances(unsigned int VAO, const Texture2D& texture, unsigned int count);
+    // draws the queued sprites now, for passes that render outside the renderer but must keep their place in the draw order
+    void flush();
 private:
     Shader m_shader;
     unsigned int m_quadVAO;
+    unsigned int m_quadVBO;
+    unsigned int m_instanceVBO;
+    unsigned int m_instanceCapacity;
+    bool m_batching;
+
+    std::vector<SpriteBatch> m_batches;
+    unsigned int m_batchCount;
+    std::vector<SpriteInstance> m_staging;
 
     void initRenderData();
+    void setInstanceOffset(unsigned int first);
+    void initVertexArray(unsigned int VAO, unsigned int instanceVBO, unsigned int first);
 };
 
 #endif
\ No newline at end of file
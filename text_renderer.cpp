@@ -1,31 +1,51 @@
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 
-#include <glm/gtc/matrix_transform.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 #include "text_renderer.h"
 #include "resource_manager.h"
+#include "gl_state.h"
+#include "trace.h"
 
-TextRenderer::TextRenderer(unsigned int width, unsigned int height) {
+const unsigned int ATLAS_WIDTH = 512;
+const unsigned int GLYPH_PADDING = 1;
+
+struct GlyphBitmap {
+    unsigned int m_x, m_y;
+    unsigned int m_width, m_height;
+    std::vector<unsigned char> m_pixels;
+};
+
+TextRenderer::TextRenderer()
+    : m_capacity(0), m_baseline(0.0f)
+{
     this->m_textShader = ResourceManager::loadShader("shaders/text.vs", "shaders/text.fs", nullptr, "text");
-    this->m_textShader.setMatrix4("projection", glm::ortho(0.f, static_cast<float>(width), static_cast<float>(height), 0.f), true);
-    this->m_textShader.setInteger("text", 0);
+    this->m_textShader.use().setInteger("text", 0);
 
     glGenVertexArrays(1, &this->VAO);
     glGenBuffers(1, &this->VBO);
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    this->initVertexArray(this->VAO, this->VBO);
+
+    glGenVertexArrays(1, &this->m_staticVAO);
+    glGenBuffers(1, &this->m_staticVBO);
+    this->initVertexArray(this->m_staticVAO, this->m_staticVBO);
+}
+
+void TextRenderer::initVertexArray(unsigned int VAO, unsigned int VBO) {
+    GLState::bindVertexArray(VAO);
+    GLState::bindArrayBuffer(VBO);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, m_position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, m_color));
+    GLState::bindArrayBuffer(0);
+    GLState::bindVertexArray(0);
 }
 
 void TextRenderer::load(std::string font, unsigned int fontSize) {
-    this->m_characters.clear();
-
     FT_Library ft;
     if (FT_Init_FreeType(&ft)) {
         std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
@@ -37,84 +57,184 @@ void TextRenderer::load(std::string font, unsigned int fontSize) {
     }
 
     FT_Set_Pixel_Sizes(face, 0, fontSize);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    for (GLubyte c = 0; c < 128; ++c) {
+    // shelf-pack the glyph bitmaps into rows of the atlas
+    GlyphBitmap glyphs[128] = {};
+    unsigned int penX = GLYPH_PADDING, penY = GLYPH_PADDING, rowHeight = 0;
+    for (unsigned int c = 0; c < 128; ++c) {
+        this->m_characters[c] = Character();
         if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
             std::cout << "ERROR::FREETYPE: Failed to load Glyph" << std::endl;
             continue;
         }
 
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0, 
-            GL_RED,
-            GL_UNSIGNED_BYTE, 
-            face->glyph->bitmap.buffer
-        );
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
-        m_characters.insert(std::pair<char, Character>(c, character));
+        FT_Bitmap& bitmap = face->glyph->bitmap;
+        GlyphBitmap& glyph = glyphs[c];
+        glyph.m_width = bitmap.width;
+        glyph.m_height = bitmap.rows;
+        for (unsigned int row = 0; row < bitmap.rows; ++row) {
+            unsigned char* source = bitmap.buffer + row * bitmap.pitch;
+            glyph.m_pixels.insert(glyph.m_pixels.end(), source, source + bitmap.width);
+        }
+
+        if (penX + glyph.m_width + GLYPH_PADDING > ATLAS_WIDTH) {
+            penX = GLYPH_PADDING;
+            penY += rowHeight + GLYPH_PADDING;
+            rowHeight = 0;
+        }
+        glyph.m_x = penX;
+        glyph.m_y = penY;
+        penX += glyph.m_width + GLYPH_PADDING;
+        rowHeight = std::max(rowHeight, glyph.m_height);
+
+        Character& character = this->m_characters[c];
+        character.m_size = glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows);
+        character.m_bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+        character.m_advance = face->glyph->advance.x;
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    unsigned int atlasHeight = penY + rowHeight + GLYPH_PADDING;
+
+    std::vector<unsigned char> pixels(ATLAS_WIDTH * atlasHeight, 0);
+    for (unsigned int c = 0; c < 128; ++c) {
+        GlyphBitmap& glyph = glyphs[c];
+        for (unsigned int row = 0; row < glyph.m_height; ++row) {
+            std::copy_n(glyph.m_pixels.begin() + row * glyph.m_width, glyph.m_width,
+                pixels.begin() + (glyph.m_y + row) * ATLAS_WIDTH + glyph.m_x);
+        }
+
+        Character& character = this->m_characters[c];
+        character.m_uvMin = glm::vec2(glyph.m_x / static_cast<float>(ATLAS_WIDTH), glyph.m_y / static_cast<float>(atlasHeight));
+        character.m_uvMax = glm::vec2((glyph.m_x + glyph.m_width) / static_cast<float>(ATLAS_WIDTH),
+            (glyph.m_y + glyph.m_height) / static_cast<float>(atlasHeight));
+    }
+    this->m_baseline = this->m_characters['H'].m_bearing.y;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    this->m_atlas.m_internalFormat = GL_RED;
+    this->m_atlas.m_imageFormat = GL_RED;
+    this->m_atlas.m_wrapS = GL_CLAMP_TO_EDGE;
+    this->m_atlas.m_wrapT = GL_CLAMP_TO_EDGE;
+    this->m_atlas.generate(ATLAS_WIDTH, atlasHeight, pixels.data());
 
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
 }
 
-void TextRenderer::renderText(std::string text, float x, float y, float scale, glm::vec3 color) {
-    this->m_textShader.use();
-    this->m_textShader.setVector3f("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
+void TextRenderer::renderText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
+    TraceScope trace("TextRenderer::renderText");
+    this->layoutText(text, x, y, scale, color, this->m_vertices);
+}
 
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); ++c) {
-        Character ch = m_characters[*c];
+void TextRenderer::layoutText(const std::string& text, float x, float y, float scale, glm::vec3 color, std::vector<TextVertex>& vertices) {
+    for (char c : text) {
+        unsigned char code = static_cast<unsigned char>(c);
+        if (code >= 128) {
+            continue;
+        }
+        const Character& ch = this->m_characters[code];
 
         float xpos = x + ch.m_bearing.x * scale;
-        float ypos = y + (this->m_characters['H'].m_bearing.y - ch.m_bearing.y) * scale;
+        float ypos = y + (this->m_baseline - ch.m_bearing.y) * scale;
 
         float w = ch.m_size.x * scale;
         float h = ch.m_size.y * scale;
 
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 0.0f },
-            { xpos,     ypos,       0.0f, 0.0f },
+        TextVertex quad[6] = {
+            { glm::vec2(xpos,     ypos + h), glm::vec2(ch.m_uvMin.x, ch.m_uvMax.y), color },
+            { glm::vec2(xpos + w, ypos),     glm::vec2(ch.m_uvMax.x, ch.m_uvMin.y), color },
+            { glm::vec2(xpos,     ypos),     glm::vec2(ch.m_uvMin.x, ch.m_uvMin.y), color },
 
-            { xpos,     ypos + h,   0.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 0.0f }
+            { glm::vec2(xpos,     ypos + h), glm::vec2(ch.m_uvMin.x, ch.m_uvMax.y), color },
+            { glm::vec2(xpos + w, ypos + h), glm::vec2(ch.m_uvMax.x, ch.m_uvMax.y), color },
+            { glm::vec2(xpos + w, ypos),     glm::vec2(ch.m_uvMax.x, ch.m_uvMin.y), color }
         };
+        vertices.insert(vertices.end(), quad, quad + 6);
 
-        glBindTexture(GL_TEXTURE_2D, ch.m_textureID);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        x += (ch.m_advance >> 6) * scale;
+    }
+}
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+void TextRenderer::flush() {
+    TraceScope trace("TextRenderer::flush");
+    if (this->m_vertices.empty() && this->m_drawFirsts.empty()) {
+        return;
+    }
 
-        x += (ch.m_advance >> 6) * scale;
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    this->m_textShader.use();
+    GLState::activeTexture(GL_TEXTURE0);
+    this->m_atlas.bind();
+
+    if (!this->m_vertices.empty()) {
+        GLState::bindArrayBuffer(this->VBO);
+        if (this->m_vertices.size() > this->m_capacity) {
+            this->m_capacity = std::max<unsigned int>(this->m_vertices.size(), this->m_capacity * 2);
+        }
+        glBufferData(GL_ARRAY_BUFFER, this->m_capacity * sizeof(TextVertex), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, this->m_vertices.size() * sizeof(TextVertex), this->m_vertices.data());
+
+        GLState::bindVertexArray(this->VAO);
+        glDrawArrays(GL_TRIANGLES, 0, this->m_vertices.size());
+        GLState::countDraw();
+        this->m_vertices.clear();
+    }
+
+    if (!this->m_drawFirsts.empty()) {
+        GLState::bindVertexArray(this->m_staticVAO);
+        glMultiDrawArrays(GL_TRIANGLES, this->m_drawFirsts.data(), this->m_drawCounts.data(), this->m_drawFirsts.size());
+        GLState::countDraw();
+        this->m_drawFirsts.clear();
+        this->m_drawCounts.clear();
+    }
+}
+
+TextHandle TextRenderer::cacheText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
+    TextMesh mesh;
+    mesh.m_x = x;
+    mesh.m_y = y;
+    mesh.m_scale = scale;
+    mesh.m_color = color;
+    mesh.m_first = 0;
+    mesh.m_count = 0;
+    mesh.m_capacity = 0;
+    this->m_meshes.push_back(mesh);
+
+    TextHandle handle = this->m_meshes.size() - 1;
+    this->setText(handle, text);
+    this->m_drawFirsts.reserve(this->m_meshes.size());
+    this->m_drawCounts.reserve(this->m_meshes.size());
+    return handle;
+}
+
+void TextRenderer::setText(TextHandle handle, const std::string& text) {
+    TextMesh& mesh = this->m_meshes[handle];
+    if (mesh.m_capacity > 0 && mesh.m_text == text) {
+        return;
+    }
+    mesh.m_text = text;
+
+    this->m_layout.clear();
+    this->layoutText(text, mesh.m_x, mesh.m_y, mesh.m_scale, mesh.m_color, this->m_layout);
+    mesh.m_count = this->m_layout.size();
+
+    GLState::bindArrayBuffer(this->m_staticVBO);
+    if (mesh.m_count <= mesh.m_capacity) {
+        std::copy(this->m_layout.begin(), this->m_layout.end(), this->m_staticVertices.begin() + mesh.m_first);
+        glBufferSubData(GL_ARRAY_BUFFER, mesh.m_first * sizeof(TextVertex), mesh.m_count * sizeof(TextVertex), this->m_layout.data());
+    } else {
+        // the string outgrew its range, move it to the end with some headroom and re-upload the whole buffer
+        mesh.m_first = this->m_staticVertices.size();
+        mesh.m_capacity = std::max<unsigned int>(mesh.m_count * 2, 6);
+        this->m_staticVertices.resize(mesh.m_first + mesh.m_capacity);
+        std::copy(this->m_layout.begin(), this->m_layout.end(), this->m_staticVertices.begin() + mesh.m_first);
+        glBufferData(GL_ARRAY_BUFFER, this->m_staticVertices.size() * sizeof(TextVertex), this->m_staticVertices.data(), GL_STATIC_DRAW);
+    }
+}
+
+void TextRenderer::drawText(TextHandle handle) {
+    const TextMesh& mesh = this->m_meshes[handle];
+    if (mesh.m_count > 0) {
+        this->m_drawFirsts.push_back(mesh.m_first);
+        this->m_drawCounts.push_back(mesh.m_count);
     }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
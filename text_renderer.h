@@ -1,7 +1,8 @@
 #ifndef TEXT_RENDERER_H
 #define TEXT_RENDERER_H
 
-#include <map>
+#include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -10,22 +11,59 @@
 #include "shader.h"
 
 struct Character {
-    unsigned int m_textureID;
+    glm::vec2 m_uvMin, m_uvMax;
     glm::ivec2 m_size;
     glm::ivec2 m_bearing;
     unsigned int m_advance;
 };
 
+struct TextVertex {
+    glm::vec2 m_position;
+    glm::vec2 m_texCoords;
+    glm::vec3 m_color;
+};
+
+// layout of a cached string inside the static vertex buffer, regenerated only when its text changes
+struct TextMesh {
+    std::string m_text;
+    float m_x, m_y, m_scale;
+    glm::vec3 m_color;
+    unsigned int m_first, m_count, m_capacity;
+};
+
+typedef unsigned int TextHandle;
+
+// glyphs 0-127 are packed into a single atlas texture. renderText only queues the quads of a string,
+// everything queued since the last flush() is drawn with one call, cached strings queued through drawText() with one more
 class TextRenderer {
 public:
-    std::map<char, Character> m_characters;
+    Character m_characters[128];
     Shader m_textShader;
+    Texture2D m_atlas;
 
-    TextRenderer(unsigned int width, unsigned int height);
+    TextRenderer();
     void load(std::string font, unsigned int fontSize);
-    void renderText(std::string text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
+    void renderText(const std::string& text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
+    void flush();
+
+    TextHandle cacheText(const std::string& text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
+    void setText(TextHandle handle, const std::string& text);
+    void drawText(TextHandle handle);
 private:
     unsigned int VAO, VBO;
+    unsigned int m_capacity;
+    float m_baseline;
+    std::vector<TextVertex> m_vertices;
+
+    unsigned int m_staticVAO, m_staticVBO;
+    std::vector<TextVertex> m_staticVertices;
+    std::vector<TextMesh> m_meshes;
+    std::vector<int> m_drawFirsts;
+    std::vector<int> m_drawCounts;
+    std::vector<TextVertex> m_layout;
+
+    void layoutText(const std::string& text, float x, float y, float scale, glm::vec3 color, std::vector<TextVertex>& vertices);
+    void initVertexArray(unsigned int VAO, unsigned int VBO);
 };
 
 #endif
\ No newline at end of file
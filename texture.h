@@ -17,6 +17,7 @@ public:
     unsigned int m_filterMin;
     unsigned int m_filterMax;
 
+    // the GL texture is only created by the first generate(), so textures can be held and copied without a context
     Texture2D();
 
     void generate(unsigned int width, unsigned int height, unsigned char* data);
@@ -0,0 +1,84 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+struct TraceEvent {
+    const char* m_name;
+    unsigned long long m_start, m_end;
+    unsigned int m_thread;
+};
+
+// small sequential ids read better in the viewers than hashed std::thread ids
+std::atomic<unsigned int> nextThreadId(1);
+std::vector<TraceEvent> events;
+
+unsigned int traceThreadId() {
+    static thread_local unsigned int id = nextThreadId++;
+    return id;
+}
+
+// instantiate static variables
+std::atomic<bool> Trace::m_recording(false);
+std::atomic<unsigned int> Trace::m_count(0);
+std::string Trace::m_file;
+unsigned int Trace::m_framesLeft = 0;
+
+void Trace::start(const std::string& file, unsigned int frames) {
+    if (recording()) {
+        stop();
+    }
+    events.resize(TRACE_MAX_EVENTS);
+    m_file = file;
+    m_framesLeft = frames;
+    m_count = 0;
+    m_recording = true;
+    std::cout << "tracing " << frames << " frames into " << file << std::endl;
+}
+
+void Trace::stop() {
+    if (!recording()) {
+        return;
+    }
+    m_recording = false;
+    unsigned int recorded = m_count.load();
+    unsigned int count = std::min(recorded, TRACE_MAX_EVENTS);
+
+    std::ofstream stream(m_file);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    unsigned long long origin = count > 0 ? events[0].m_start : 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        origin = std::min(origin, events[i].m_start);
+    }
+    for (unsigned int i = 0; i < count; ++i) {
+        const TraceEvent& event = events[i];
+        stream << (i > 0 ? ",\n" : "\n") << "{\"name\":\"" << event.m_name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.m_thread
+            << ",\"ts\":" << (event.m_start - origin) / 1000.0 << ",\"dur\":" << (event.m_end - event.m_start) / 1000.0 << "}";
+    }
+    stream << "\n]}\n";
+
+    if (!stream.good()) {
+        std::cout << "ERROR::TRACE: Failed to write " << m_file << std::endl;
+        return;
+    }
+    std::cout << "wrote " << count << " trace events to " << m_file;
+    if (recorded > count) {
+        std::cout << ", dropped " << recorded - count;
+    }
+    std::cout << std::endl;
+}
+
+void Trace::beginFrame() {
+    if (recording() && m_framesLeft-- == 0) {
+        stop();
+    }
+}
+
+void Trace::record(const char* name, unsigned long long start, unsigned long long end) {
+    unsigned int index = m_count.fetch_add(1, std::memory_order_relaxed);
+    if (index < TRACE_MAX_EVENTS) {
+        events[index] = { name, start, end, traceThreadId() };
+    }
+}
\ No newline at end of file
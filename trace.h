@@ -0,0 +1,49 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <string>
+
+#include "profiler.h"
+
+// events past this are dropped and counted, the buffer is allocated once when a capture starts
+const unsigned int TRACE_MAX_EVENTS = 1 << 16;
+
+// records complete spans for a window of frames and writes them in the Chrome trace event format, which
+// chrome://tracing and ui.perfetto.dev open directly. recording is a single atomic index bump, not recording costs
+// each TraceScope one relaxed load
+class Trace {
+public:
+    // starts capturing into file for the next frames frames, a running capture is written out first
+    static void start(const std::string& file, unsigned int frames);
+    // writes the capture and stops recording
+    static void stop();
+    // ends the capture once its window of frames has passed
+    static void beginFrame();
+
+    static bool recording() { return m_recording.load(std::memory_order_relaxed); }
+    static void record(const char* name, unsigned long long start, unsigned long long end);
+private:
+    Trace() {}
+
+    static std::atomic<bool> m_recording;
+    static std::atomic<unsigned int> m_count;
+    static std::string m_file;
+    static unsigned int m_framesLeft;
+};
+
+// name has to outlive the capture, string literals are the intended use
+class TraceScope {
+public:
+    TraceScope(const char* name) : m_name(Trace::recording() ? name : nullptr), m_start(m_name ? Profiler::now() : 0) {}
+    ~TraceScope() {
+        if (this->m_name) {
+            Trace::record(this->m_name, this->m_start, Profiler::now());
+        }
+    }
+private:
+    const char* m_name;
+    unsigned long long m_start;
+};
+
+#endif
\ No newline at end of file